@@ -1,299 +1,522 @@
 #include <math.h>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <initializer_list>
+#include <vector>
+#include <unordered_map>
 #include <DirectXMath.h>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 
 #include "BasicShapes.h"
 
 #include "Mesh.h"
+#include "Parallel.h"
+#include "ShapeTables.h"
+#include "Meshlets.h"
 
 using namespace Learnings;
 namespace Math = DirectX;
 
-static Mesh SubDivideMesh(Mesh mesh, uint16_t level)
+// Write cursor over caller owned vertex/index memory
+struct SpanWriter
 {
-	if (level < 1)
+	Vertex *vertex;
+	uint32_t *index;
+
+	SpanWriter(const MeshSpan &span)
+		: vertex(span.vertices),
+		index(span.indices)
+	{}
+
+	void Add(const Vertex &v)
 	{
-		return mesh;
+		*vertex++ = v;
 	}
 
-	if (level > 1)
+	void Add(std::initializer_list<uint32_t> idx)
 	{
-		mesh = SubDivideMesh(mesh, level - 1);
+		for (auto i : idx)
+		{
+			*index++ = i;
+		}
 	}
+};
 
-	Mesh subdMesh;
-	auto numTriangles = mesh.indices.size() / 3u;
-
-	for (decltype(numTriangles) i = 0; i < numTriangles; i++)
+static void CheckSpan(const MeshSpan &out, const MeshSize &size)
+{
+	if (out.vertexCount < size.vertexCount || out.indexCount < size.indexCount)
 	{
-		Vertex v0 = mesh.vertices[mesh.indices[i * 3]],
-			v1 = mesh.vertices[mesh.indices[i * 3 + 1]],
-			v2 = mesh.vertices[mesh.indices[i * 3 + 2]];
-
-		Vertex m0, m1, m2;
-		m0 = {
-			{
-				0.5f * (v0.position.x + v1.position.x),
-				0.5f * (v0.position.y + v1.position.y),
-				0.5f * (v0.position.z + v1.position.z)
-			},
-			{
-				0.5f * (v0.texCoord.x + v1.texCoord.x),
-				0.5f * (v0.texCoord.y + v1.texCoord.y)
-			}
-		};
+		throw std::length_error("Mesh span is too small for shape");
+	}
+}
 
-		m1 = {
-			{
-				0.5f * (v1.position.x + v2.position.x),
-				0.5f * (v1.position.y + v2.position.y),
-				0.5f * (v1.position.z + v2.position.z)
-			},
-			{
-				0.5f * (v1.texCoord.x + v2.texCoord.x),
-				0.5f * (v1.texCoord.y + v2.texCoord.y)
-			}
-		};
+void Learnings::WriteUnitMesh(const MeshSpan &out,
+							  const UnitVertex *vertices, uint32_t vertexCount,
+							  const uint32_t *indices, uint32_t indexCount,
+							  const Math::XMFLOAT3 &scale, const Math::XMFLOAT3 &offset)
+{
+	CheckSpan(out, { vertexCount, indexCount });
 
-		m2 = {
-			{
-				0.5f * (v0.position.x + v2.position.x),
-				0.5f * (v0.position.y + v2.position.y),
-				0.5f * (v0.position.z + v2.position.z)
-			},
-			{
-				0.5f * (v0.texCoord.x + v2.texCoord.x),
-				0.5f * (v0.texCoord.y + v2.texCoord.y)
-			}
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		const UnitVertex &v = vertices[i];
+		out.vertices[i] = {
+			{ v.x * scale.x + offset.x, v.y * scale.y + offset.y, v.z * scale.z + offset.z },
+			{ v.u, v.v }
 		};
+	}
 
-		subdMesh.vertices.insert(subdMesh.vertices.end(), {
-			v0, v1, v2, m0, m1, m2
-		});
+	std::memcpy(out.indices, indices, indexCount * sizeof(uint32_t));
+}
 
-		uint32_t n = static_cast<uint32_t>(i) * 6u;
-		subdMesh.indices.insert(subdMesh.indices.end(), {
-			n + 0, n + 3, n + 5,
-			n + 3, n + 4, n + 5,
-			n + 5, n + 4, n + 2,
-			n + 3, n + 1, n + 4
-		});
+static D3D11_PRIMITIVE_TOPOLOGY Topology(PrimitiveMode mode)
+{
+	switch (mode)
+	{
+		case PrimitiveMode::LineList:
+			return D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
+		case PrimitiveMode::TriangleStrip:
+			return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+		default:
+			return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 	}
-
-	return subdMesh;
 }
 
-Mesh Learnings::Triangle(float base, float height, float tipOffset)
+template <typename SizeFn, typename FillFn>
+static Mesh MakeMesh(SizeFn sizeFn, FillFn fillFn)
 {
-	float halfHeight = height / 2.0f;
-	float halfBase = base / 2.0f;
+	Mesh shape;
+	fillFn(shape.Resize(sizeFn()));
+	shape.UpdateBounds();
 
-	float x1 = -halfBase, y1 = -halfHeight,
-		x3 = base * tipOffset, y3 = halfHeight,
-		x2 = halfBase, y2 = y1;
+	return shape;
+}
 
-	float oset = 0.5f + tipOffset;
+static Vertex MidPoint(const Vertex &v0, const Vertex &v1)
+{
 	return{
-		// Vertex List
 		{
-			{ { x3, y3, 0.0f },{ oset, 0.0f } },
-			{ { x2, y2, 0.0f },{ 1.0f, 1.0f } },
-			{ { x1, y1, 0.0f },{ 0.0f, 1.0f } },
+			0.5f * (v0.position.x + v1.position.x),
+			0.5f * (v0.position.y + v1.position.y),
+			0.5f * (v0.position.z + v1.position.z)
 		},
-
-		// Index List
-		{ 0, 1, 2 }
+		{
+			0.5f * (v0.texCoord.x + v1.texCoord.x),
+			0.5f * (v0.texCoord.y + v1.texCoord.y)
+		}
 	};
 }
 
-Mesh Learnings::Rectangle(float length, float width)
+typedef std::unordered_map<uint64_t, uint32_t> EdgeMap;
+
+static uint64_t EdgeKey(uint32_t i0, uint32_t i1)
 {
-	float l = length / 2.0f;
-	float w = width / 2.0f;
+	return (i0 < i1) ?
+		(static_cast<uint64_t>(i0) << 32) | i1 :
+		(static_cast<uint64_t>(i1) << 32) | i0;
+}
 
-	return{
-		// Vertex List
-		{
-			{ { -l, +w, 0.0f },{ 0.0f, 0.0f } },
-			{ { +l, +w, 0.0f },{ 1.0f, 0.0f } },
-			{ { +l, -w, 0.0f },{ 1.0f, 1.0f } },
-			{ { -l, -w, 0.0f },{ 0.0f, 1.0f } },
-		},
+// Vertex/index count after subdividing a base mesh with edgeCount unique edges
+static MeshSize SubDivideSize(MeshSize base, uint32_t edgeCount, uint16_t level, SubDivideMode mode)
+{
+	MeshSize size = base;
 
-		// Index List
-		{ 
-			0, 1, 2, 
-			0, 2, 3
+	for (uint16_t l = 1; l <= level; l++)
+	{
+		uint32_t triangleCount = size.indexCount / 3u;
+
+		if (mode == SubDivideMode::Shared)
+		{
+			// each edge adds a vertex and splits in 2, each triangle adds 3 inner edges
+			size.vertexCount += edgeCount;
+			edgeCount = edgeCount * 2u + triangleCount * 3u;
 		}
-	};
+		else
+		{
+			size.vertexCount = triangleCount * 6u;
+		}
+
+		size.indexCount = triangleCount * 12u;
+	}
+
+	return size;
 }
 
-Mesh Learnings::Box(float length, float width, float height)
+// Split every triangle into 4 while keeping vertices welded, in place.
+// Each edge midpoint is created once, keyed on its (min, max) index pair,
+// and then reused by the triangle on the other side of that edge.
+// Midpoints are appended after the existing vertices, and the current
+// indices are moved to the tail of the index range so each level can be
+// read from the back while the 4 new triangles are written from the front.
+// out must be sized for SubDivideSize(base, edgeCount, level, Shared).
+static void SubDivideShared(const MeshSpan &out, MeshSize base, uint32_t edgeCount, uint16_t level)
 {
-	float l = length / 2.0f;
-	float w = width / 2.0f;
-	float h = height / 2.0f;
+	MeshSize size = base;
+	EdgeMap midPoints;
 
-	return{
-		// Vertex List
-		{
-			// Front
-			{ { -l, -w, +h },{ 0.0f, 0.0f } },
-			{ { +l, -w, +h },{ 1.0f, 0.0f } },
-			{ { +l, +w, +h },{ 1.0f, 1.0f } },
-			{ { -l, +w, +h },{ 0.0f, 1.0f } },
-
-			// Bottom
-			{ { -l, -w, -h },{ 0.0f, 0.0f } },
-			{ { +l, -w, -h },{ 1.0f, 0.0f } },
-			{ { +l, -w, +h },{ 1.0f, 1.0f } },
-			{ { -l, -w, +h },{ 0.0f, 1.0f } },
-
-			// Right
-			{ { +l, -w, -h },{ 0.0f, 0.0f } },
-			{ { +l, +w, -h },{ 1.0f, 0.0f } },
-			{ { +l, +w, +h },{ 1.0f, 1.0f } },
-			{ { +l, -w, +h },{ 0.0f, 1.0f } },
-
-			// Left
-			{ { -l, -w, -h },{ 0.0f, 0.0f } },
-			{ { -l, -w, +h },{ 1.0f, 0.0f } },
-			{ { -l, +w, +h },{ 1.0f, 1.0f } },
-			{ { -l, +w, -h },{ 0.0f, 1.0f } },
-
-			// Back
-			{ { -l, -w, -h },{ 0.0f, 0.0f } },
-			{ { -l, +w, -h },{ 1.0f, 0.0f } },
-			{ { +l, +w, -h },{ 1.0f, 1.0f } },
-			{ { +l, -w, -h },{ 0.0f, 1.0f } },
-
-			// Top
-			{ { -l, +w, -h },{ 0.0f, 0.0f } },
-			{ { -l, +w, +h },{ 1.0f, 0.0f } },
-			{ { +l, +w, +h },{ 1.0f, 1.0f } },
-			{ { +l, +w, -h },{ 0.0f, 1.0f } },
-		},
+	for (uint16_t l = 1; l <= level; l++)
+	{
+		uint32_t triangleCount = size.indexCount / 3u;
+		uint32_t nextVertex = size.vertexCount;
+		uint32_t readOffset = triangleCount * 9u;
 
+		std::memmove(out.indices + readOffset, out.indices, size.indexCount * sizeof(uint32_t));
 
-		// Index List
+		midPoints.clear();
+		midPoints.reserve(edgeCount);
+
+		auto midPoint = [&](uint32_t i0, uint32_t i1) -> uint32_t
 		{
-			// Front
-			0, 1, 2, 0, 2, 3,
-			// Bottom
-			4, 5, 6, 4, 6, 7,
-			// Right
-			8, 9, 10, 8, 10, 11,
-			// Left
-			12, 13, 14, 12, 14, 15,
-			// Back
-			16, 17, 18, 16, 18, 19,
-			// Top
-			20, 21, 22, 20, 22, 23,
+			auto result = midPoints.insert({ EdgeKey(i0, i1), nextVertex });
+			if (result.second)
+			{
+				out.vertices[nextVertex++] = MidPoint(out.vertices[i0], out.vertices[i1]);
+			}
+
+			return result.first->second;
+		};
+
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t *in = out.indices + readOffset + i * 3;
+			uint32_t n0 = in[0],
+				n1 = in[1],
+				n2 = in[2];
+
+			uint32_t m0 = midPoint(n0, n1),
+				m1 = midPoint(n1, n2),
+				m2 = midPoint(n0, n2);
+
+			uint32_t *idx = out.indices + i * 12;
+			idx[0] = n0; idx[1] = m0; idx[2] = m2;
+			idx[3] = m0; idx[4] = m1; idx[5] = m2;
+			idx[6] = m2; idx[7] = m1; idx[8] = n2;
+			idx[9] = m0; idx[10] = n1; idx[11] = m1;
 		}
-	};
+
+		assert(nextVertex == size.vertexCount + edgeCount && "edge count did not match midpoints created");
+
+		size.vertexCount = nextVertex;
+		size.indexCount = triangleCount * 12u;
+		edgeCount = edgeCount * 2u + triangleCount * 3u;
+	}
 }
 
-Mesh Learnings::Tetrahedron(float radius)
+// Split every triangle of in into 4, giving each source triangle its own 6 vertices.
+static void SplitTriangles(const Mesh &in, const MeshSpan &out)
 {
-	Mesh shape;
+	auto numTriangles = in.indices.size() / 3u;
 
-	shape.vertices.push_back(Vertex{ {0.0f, radius, 0.0f}, {0.0f, 0.0f} });
-	
-	uint8_t basePointCnt = 3;
-	float angle = Math::XM_2PI / basePointCnt; // number of point in base
-	float theta = 0.0f;
-	for (uint8_t i = 0; i < basePointCnt; i++)
+	for (decltype(numTriangles) i = 0; i < numTriangles; i++)
 	{
-		float x, y, z;
-		x = radius * std::cosf(theta); 
-		y = radius * std::cosf(angle);
-		z = radius * std::sinf(theta); 
+		Vertex v0 = in.vertices[in.indices[i * 3]],
+			v1 = in.vertices[in.indices[i * 3 + 1]],
+			v2 = in.vertices[in.indices[i * 3 + 2]];
+
+		Vertex *vtx = out.vertices + i * 6;
+		vtx[0] = v0;
+		vtx[1] = v1;
+		vtx[2] = v2;
+		vtx[3] = MidPoint(v0, v1);
+		vtx[4] = MidPoint(v1, v2);
+		vtx[5] = MidPoint(v0, v2);
 
-		theta += angle;
+		uint32_t n = static_cast<uint32_t>(i) * 6u;
+		uint32_t *idx = out.indices + i * 12;
+		idx[0] = n + 0; idx[1] = n + 3; idx[2] = n + 5;
+		idx[3] = n + 3; idx[4] = n + 4; idx[5] = n + 5;
+		idx[6] = n + 5; idx[7] = n + 4; idx[8] = n + 2;
+		idx[9] = n + 3; idx[10] = n + 1; idx[11] = n + 4;
+	}
+}
 
-		shape.vertices.push_back(Vertex{ {x, y, z}, {0.0f, 0.0f} });
+// Subdivide the base mesh already written to the front of out.
+// Shared mode works entirely inside out. Split mode gives every triangle
+// its own vertices on the last level, so the levels before it are built
+// welded in a scratch mesh and then expanded into out.
+static void SubDivideMesh(const MeshSpan &out, MeshSize base, uint32_t edgeCount, uint16_t level, SubDivideMode mode)
+{
+	if (level < 1)
+	{
+		return;
+	}
+
+	if (mode == SubDivideMode::Shared)
+	{
+		SubDivideShared(out, base, edgeCount, level);
+		return;
 	}
 
-	// duplicate points for nicer UV map
-	auto v0 = shape.vertices[0],
-		v1 = shape.vertices[1];
-	shape.vertices.insert(shape.vertices.end(), { v0, v1 });
+	MeshSize size = SubDivideSize(base, edgeCount, level - 1, SubDivideMode::Shared);
 
-	// Map UV -> |/\/\/|
-	for (uint8_t i = 0; i < 6; i++)
+	Mesh scratch;
+	MeshSpan scratchSpan = scratch.Resize(size);
+	std::memcpy(scratchSpan.vertices, out.vertices, base.vertexCount * sizeof(Vertex));
+	std::memcpy(scratchSpan.indices, out.indices, base.indexCount * sizeof(uint32_t));
+
+	SubDivideShared(scratchSpan, base, edgeCount, level - 1);
+
+	SplitTriangles(scratch, out);
+}
+
+// Sine and cosine of count evenly spaced angles, start + i * step.
+// Generators build each ring once and reuse it for every stack/cap
+// instead of calling sinf/cosf per vertex.
+struct SinCosRing
+{
+	std::vector<float> sin;
+	std::vector<float> cos;
+
+	SinCosRing(uint32_t count, float step, float start = 0.0f)
 	{
-		float u, v = 0.0f;
-		
-		if (i % 2 == 0)
+		using namespace Math;
+
+		// 4 angles per XMVectorSinCos, padded so the last store stays in bounds
+		uint32_t padded = (count + 3u) & ~3u;
+		sin.resize(padded);
+		cos.resize(padded);
+
+		const XMVECTOR lanes = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+		const XMVECTOR vStep = XMVectorReplicate(step);
+		const XMVECTOR vStart = XMVectorReplicate(start);
+
+		for (uint32_t i = 0; i < padded; i += 4)
 		{
-			v = 1.0f;
+			XMVECTOR n = XMVectorAdd(XMVectorReplicate(static_cast<float>(i)), lanes);
+			XMVECTOR angle = XMVectorMultiplyAdd(n, vStep, vStart);
+
+			XMVECTOR s, c;
+			XMVectorSinCos(&s, &c, angle);
+
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(&sin[i]), s);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(&cos[i]), c);
 		}
 
-		u = i / 6.0f;
-		
-		shape.vertices[i].texCoord = { u, v };
+		sin.resize(count);
+		cos.resize(count);
 	}
+};
 
-	shape.indices = {
-		0, 2, 1,
-		1, 2, 3,
-		2, 4, 3, 
-		3, 4, 5
-	};
+// Normalise count SoA positions and scale them to radius.
+// 8 at a time with AVX, 4 at a time with SSE, scalar for the rest
+static void NormalizeScale(float *x, float *y, float *z, uint32_t count, float radius)
+{
+	uint32_t i = 0;
 
-	return shape;
+#if defined(__AVX__)
+	const __m256 r8 = _mm256_set1_ps(radius);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 vx = _mm256_loadu_ps(x + i),
+			vy = _mm256_loadu_ps(y + i),
+			vz = _mm256_loadu_ps(z + i);
+
+		__m256 lenSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+		__m256 scale = _mm256_div_ps(r8, _mm256_sqrt_ps(lenSq));
+
+		_mm256_storeu_ps(x + i, _mm256_mul_ps(vx, scale));
+		_mm256_storeu_ps(y + i, _mm256_mul_ps(vy, scale));
+		_mm256_storeu_ps(z + i, _mm256_mul_ps(vz, scale));
+	}
+#endif
+
+#if defined(_XM_SSE_INTRINSICS_)
+	const __m128 r4 = _mm_set1_ps(radius);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 vx = _mm_loadu_ps(x + i),
+			vy = _mm_loadu_ps(y + i),
+			vz = _mm_loadu_ps(z + i);
+
+		__m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+		__m128 scale = _mm_div_ps(r4, _mm_sqrt_ps(lenSq));
+
+		_mm_storeu_ps(x + i, _mm_mul_ps(vx, scale));
+		_mm_storeu_ps(y + i, _mm_mul_ps(vy, scale));
+		_mm_storeu_ps(z + i, _mm_mul_ps(vz, scale));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float scale = radius / std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+
+		x[i] *= scale;
+		y[i] *= scale;
+		z[i] *= scale;
+	}
 }
 
-Mesh Learnings::Octahedron(float radius)
+// Push every vertex out onto the sphere.
+// Positions are moved into small SoA blocks so the kernel runs at full SIMD width.
+static void ProjectToSphere(Vertex *vertices, uint32_t count, float radius)
 {
-	return{
+	const uint32_t C_BlockSize = 64;
+	alignas(32) float x[C_BlockSize], y[C_BlockSize], z[C_BlockSize];
+
+	for (uint32_t start = 0; start < count; start += C_BlockSize)
+	{
+		uint32_t n = std::min(C_BlockSize, count - start);
+		Vertex *block = vertices + start;
+
+		for (uint32_t i = 0; i < n; i++)
 		{
-			{ { radius, 0.0f, 0.0f },{ 0.0f, 0.5f } },
-			{ { 0.0f, radius, 0.0f },{ 0.5f, 0.0f } },
-			{ { 0.0f, 0.0f, radius },{ 0.33f, 0.5f } },
-			{ { -radius, 0.0f, 0.0f },{ 0.66f, 0.5f } },
-			{ { 0.0f, -radius, 0.0f },{ 0.5f, 1.0f } },
-			{ { 0.0f, 0.0f, -radius },{ 1.0f, 0.5f } },
-		},
+			x[i] = block[i].position.x;
+			y[i] = block[i].position.y;
+			z[i] = block[i].position.z;
+		}
+
+		NormalizeScale(x, y, z, n, radius);
+
+		for (uint32_t i = 0; i < n; i++)
 		{
-			// Top
-			0, 1, 2,
-			2, 1, 3,
-			3, 1, 5,
-			5, 1, 0,
-			// Bottom
-			2, 4, 0,
-			3, 4, 2,
-			5, 4, 3,
-			0, 4, 5
+			block[i].position = { x[i], y[i], z[i] };
 		}
-	};
+	}
 }
 
-Mesh Learnings::Icosahedron(float radius, uint16_t subdivide)
+#pragma region Triangle
+MeshSize Learnings::TriangleSize()
 {
-	Mesh shape;
-	
-	float phi = 0, theta = 0;
+	return C_UnitTriangle.Size();
+}
+
+void Learnings::Triangle(const MeshSpan &out, float base, float height, float tipOffset)
+{
+	WriteUnitMesh(out, C_UnitTriangle, { base, height, 1.0f }, { 0.0f, 0.0f, 0.0f });
+
+	// Slide the tip along the top edge
+	out.vertices[0].position.x += base * tipOffset;
+	out.vertices[0].texCoord.x += tipOffset;
+}
+
+Mesh Learnings::Triangle(float base, float height, float tipOffset)
+{
+	return MakeMesh([&]() { return TriangleSize(); },
+					[&](const MeshSpan &out) { Triangle(out, base, height, tipOffset); });
+}
+#pragma endregion
+
+#pragma region Rectangle
+MeshSize Learnings::RectangleSize()
+{
+	return C_UnitRectangle.Size();
+}
+
+void Learnings::Rectangle(const MeshSpan &out, float length, float width)
+{
+	WriteUnitMesh(out, C_UnitRectangle, { length, width, 1.0f }, { 0.0f, 0.0f, 0.0f });
+}
+
+Mesh Learnings::Rectangle(float length, float width)
+{
+	return MakeMesh([&]() { return RectangleSize(); },
+					[&](const MeshSpan &out) { Rectangle(out, length, width); });
+}
+#pragma endregion
+
+#pragma region Box
+MeshSize Learnings::BoxSize()
+{
+	return C_UnitBox.Size();
+}
+
+void Learnings::Box(const MeshSpan &out, float length, float width, float height)
+{
+	WriteUnitMesh(out, C_UnitBox, { length, width, height }, { 0.0f, 0.0f, 0.0f });
+}
+
+Mesh Learnings::Box(float length, float width, float height)
+{
+	return MakeMesh([&]() { return BoxSize(); },
+					[&](const MeshSpan &out) { Box(out, length, width, height); });
+}
+#pragma endregion
+
+#pragma region Tetrahedron
+MeshSize Learnings::TetrahedronSize()
+{
+	return C_UnitTetrahedron.Size();
+}
+
+void Learnings::Tetrahedron(const MeshSpan &out, float radius)
+{
+	WriteUnitMesh(out, C_UnitTetrahedron, { radius, radius, radius }, { 0.0f, 0.0f, 0.0f });
+}
+
+Mesh Learnings::Tetrahedron(float radius)
+{
+	return MakeMesh([&]() { return TetrahedronSize(); },
+					[&](const MeshSpan &out) { Tetrahedron(out, radius); });
+}
+#pragma endregion
+
+#pragma region Octahedron
+MeshSize Learnings::OctahedronSize()
+{
+	return C_UnitOctahedron.Size();
+}
+
+void Learnings::Octahedron(const MeshSpan &out, float radius)
+{
+	WriteUnitMesh(out, C_UnitOctahedron, { radius, radius, radius }, { 0.0f, 0.0f, 0.0f });
+}
+
+Mesh Learnings::Octahedron(float radius)
+{
+	return MakeMesh([&]() { return OctahedronSize(); },
+					[&](const MeshSpan &out) { Octahedron(out, radius); });
+}
+#pragma endregion
+
+#pragma region Icosahedron
+// Base icosahedron, before subdivision.
+// Poles and the ring seam use their own vertices for the UV map.
+static const MeshSize C_IcosahedronBase{ 22, 60 };
+static const uint32_t C_IcosahedronEdges = 41;
+
+MeshSize Learnings::IcosahedronSize(uint16_t subdivide, SubDivideMode mode)
+{
+	return SubDivideSize(C_IcosahedronBase, C_IcosahedronEdges, subdivide, mode);
+}
+
+// Write the 22 vertices and 20 faces of the base icosahedron to the front of out
+static void IcosahedronBase(const MeshSpan &out, float radius)
+{
+	SpanWriter shape(out);
+
+	float phi = 0;
 	float dphi = Math::XM_PI / 3;
 	float dtheta = Math::XM_2PI / 5;
 
-	auto points = [&](int n) {
-		for (int i = 0; i < n; i++)
+	// Rings alternate between starting at 0 and at half a step
+	SinCosRing ring(6, dtheta);
+	SinCosRing halfRing(6, dtheta, dtheta / 2.0f);
+
+	auto points = [&](const SinCosRing &r, float start, int first, int n) {
+		float sinPhi, cosPhi;
+		Math::XMScalarSinCos(&sinPhi, &cosPhi, phi);
+
+		for (int i = first; i < first + n; i++)
 		{
 			float x, y, z;
 			float u, v;
 
-			x = radius * cos(theta) * sin(phi);
-			z = radius * sin(theta) * sin(phi);
-			y = radius * cos(phi);
+			x = radius * r.cos[i] * sinPhi;
+			z = radius * r.sin[i] * sinPhi;
+			y = radius * cosPhi;
 
-			u = theta / Math::XM_2PI;
+			u = (start + i * dtheta) / Math::XM_2PI;
 			v = phi / Math::XM_PI;
 
-
-			theta += dtheta;
-			shape.vertices.push_back({
+			shape.Add({
 				{ x, y, z },{ u, v }
 			});
 
@@ -302,25 +525,21 @@ Mesh Learnings::Icosahedron(float radius, uint16_t subdivide)
 
 	// Pole
 	phi = 0;
-	theta = dtheta / 2.0f;
-	points(5);
+	points(halfRing, dtheta / 2.0f, 0, 5);
 
 	// 1st Ring
 	phi = dphi;
-	theta = 0;
-	points(6);
-	
+	points(ring, 0.0f, 0, 6);
+
 	// 2st Ring
 	phi += dphi;
-	theta = dtheta / 2.0f;
-	points(6);
-	
+	points(halfRing, dtheta / 2.0f, 0, 6);
+
 	// Pole
 	phi += dphi;
-	theta = dtheta;
-	points(5);
+	points(ring, 0.0f, 1, 5);
 
-	// Indices 
+	// Indices
 	for (int i = 5; i < 10; i++)
 	{
 		uint32_t n1, n2, n3, n4, n5, n6;
@@ -331,47 +550,228 @@ Mesh Learnings::Icosahedron(float radius, uint16_t subdivide)
 		n5 = n4 + 1;
 		n6 = n4 + 6;
 
-		shape.indices.insert(shape.indices.end(), {
+		shape.Add({
 			n1, n2, n3,
 			n1, n3, n4,
 			n4, n3, n5,
 			n4, n5, n6
 		});
 	}
+}
+
+void Learnings::Icosahedron(const MeshSpan &out, float radius, uint16_t subdivide, SubDivideMode mode)
+{
+	MeshSize size = IcosahedronSize(subdivide, mode);
+	CheckSpan(out, size);
+
+	IcosahedronBase(out, radius);
+
+	SubDivideMesh(out, C_IcosahedronBase, C_IcosahedronEdges, subdivide, mode);
+
+	ProjectToSphere(out.vertices, size.vertexCount, radius);
+}
+
+Mesh Learnings::Icosahedron(float radius, uint16_t subdivide, SubDivideMode mode)
+{
+	return MakeMesh([&]() { return IcosahedronSize(subdivide, mode); },
+					[&](const MeshSpan &out) { Icosahedron(out, radius, subdivide, mode); });
+}
+#pragma endregion
+
+#pragma region Geodesic Sphere
+// Every face of the base icosahedron is split into frequency^2 triangles.
+// Corners come first, then frequency - 1 vertices per base edge,
+// then the (frequency - 1)(frequency - 2) / 2 vertices inside each face.
+MeshSize Learnings::GeodesicSphereSize(uint16_t frequency)
+{
+	uint32_t n = std::max<uint32_t>(frequency, 1u);
+	uint32_t faceCount = C_IcosahedronBase.indexCount / 3u;
+
+	uint32_t vertexCount = C_IcosahedronBase.vertexCount
+		+ C_IcosahedronEdges * (n - 1u)
+		+ faceCount * (n - 1u) * (n - 2u) / 2u;
+	uint32_t indexCount = faceCount * n * n * 3u;
+
+	return{ vertexCount, indexCount };
+}
+
+void Learnings::GeodesicSphere(const MeshSpan &out, float radius, uint16_t frequency)
+{
+	MeshSize size = GeodesicSphereSize(frequency);
+	CheckSpan(out, size);
+
+	const uint32_t n = std::max<uint32_t>(frequency, 1u);
+	const float step = 1.0f / n;
 
-	shape = SubDivideMesh(shape, subdivide);
+	Vertex baseVertices[22];
+	uint32_t baseIndices[60];
+	IcosahedronBase(MeshSpan{ baseVertices, 22, baseIndices, 60 }, radius);
 
-	using namespace Math;
-	for (auto &vtx : shape.vertices)
+	auto lerp = [](const Vertex &v0, const Vertex &v1, float t) -> Vertex
 	{
-		XMVECTOR n = Math::XMVector3Normalize(XMLoadFloat3(&vtx.position));
-		XMVECTOR p = radius * n;
+		return{
+			{
+				v0.position.x + (v1.position.x - v0.position.x) * t,
+				v0.position.y + (v1.position.y - v0.position.y) * t,
+				v0.position.z + (v1.position.z - v0.position.z) * t
+			},
+			{
+				v0.texCoord.x + (v1.texCoord.x - v0.texCoord.x) * t,
+				v0.texCoord.y + (v1.texCoord.y - v0.texCoord.y) * t
+			}
+		};
+	};
 
-		XMStoreFloat3(&vtx.position, p);
+	// Corners
+	for (uint32_t i = 0; i < C_IcosahedronBase.vertexCount; i++)
+	{
+		out.vertices[i] = baseVertices[i];
 	}
 
+	uint32_t edgeStart = C_IcosahedronBase.vertexCount;
+	uint32_t nextVertex = edgeStart + C_IcosahedronEdges * (n - 1u);
+	uint32_t *idx = out.indices;
 
-	return shape;
+	// Edge vertices are created by the first face to reach an edge,
+	// running from its lower to its higher corner index
+	EdgeMap edges;
+	edges.reserve(C_IcosahedronEdges);
+
+	auto edgeVertex = [&](uint32_t p, uint32_t q, uint32_t k) -> uint32_t
+	{
+		uint32_t first = edgeStart + static_cast<uint32_t>(edges.size()) * (n - 1u);
+		auto result = edges.insert({ EdgeKey(p, q), first });
+		if (result.second)
+		{
+			uint32_t lo = std::min(p, q), hi = std::max(p, q);
+			for (uint32_t s = 1; s < n; s++)
+			{
+				out.vertices[first + s - 1] = lerp(baseVertices[lo], baseVertices[hi], s * step);
+			}
+		}
+
+		uint32_t slot = (p < q) ? k : n - k;
+		return result.first->second + slot - 1;
+	};
+
+	std::vector<uint32_t> faceGrid((n + 1) * (n + 2) / 2);
+
+	for (uint32_t f = 0; f < C_IcosahedronBase.indexCount; f += 3)
+	{
+		uint32_t a = baseIndices[f],
+			b = baseIndices[f + 1],
+			c = baseIndices[f + 2];
+
+		// Vertex index of grid point i steps towards b and j steps towards c
+		auto grid = [&](uint32_t i, uint32_t j) -> uint32_t &
+		{
+			return faceGrid[i * (2 * n + 3 - i) / 2 + j];
+		};
+
+		for (uint32_t i = 0; i <= n; i++)
+		{
+			for (uint32_t j = 0; j <= n - i; j++)
+			{
+				uint32_t vtx;
+
+				if (i == 0 && j == 0)			vtx = a;
+				else if (i == n)				vtx = b;
+				else if (j == n)				vtx = c;
+				else if (j == 0)				vtx = edgeVertex(a, b, i);
+				else if (i == 0)				vtx = edgeVertex(a, c, j);
+				else if (i + j == n)			vtx = edgeVertex(b, c, j);
+				else
+				{
+					vtx = nextVertex++;
+					Vertex ab = lerp(baseVertices[a], baseVertices[b], i * step);
+					Vertex ac = lerp(baseVertices[a], baseVertices[c], j * step);
+
+					// a + (b - a) i/n + (c - a) j/n
+					out.vertices[vtx] = {
+						{
+							ab.position.x + ac.position.x - baseVertices[a].position.x,
+							ab.position.y + ac.position.y - baseVertices[a].position.y,
+							ab.position.z + ac.position.z - baseVertices[a].position.z
+						},
+						{
+							ab.texCoord.x + ac.texCoord.x - baseVertices[a].texCoord.x,
+							ab.texCoord.y + ac.texCoord.y - baseVertices[a].texCoord.y
+						}
+					};
+				}
+
+				grid(i, j) = vtx;
+			}
+		}
+
+		for (uint32_t i = 0; i < n; i++)
+		{
+			for (uint32_t j = 0; j < n - i; j++)
+			{
+				// Same winding as a, b, c
+				*idx++ = grid(i, j);
+				*idx++ = grid(i + 1, j);
+				*idx++ = grid(i, j + 1);
+
+				if (i + j + 1 < n)
+				{
+					*idx++ = grid(i + 1, j);
+					*idx++ = grid(i + 1, j + 1);
+					*idx++ = grid(i, j + 1);
+				}
+			}
+		}
+	}
+
+	assert(nextVertex == size.vertexCount && "geodesic vertex count mismatch");
+	assert((n == 1 || edges.size() == C_IcosahedronEdges) && "geodesic edge count mismatch");
+
+	ProjectToSphere(out.vertices, size.vertexCount, radius);
 }
 
-Mesh Learnings::Dodecahedron(float radius, uint16_t subdivide)
+Mesh Learnings::GeodesicSphere(float radius, uint16_t frequency)
 {
-	Mesh shape;
+	return MakeMesh([&]() { return GeodesicSphereSize(frequency); },
+					[&](const MeshSpan &out) { GeodesicSphere(out, radius, frequency); });
+}
+#pragma endregion
 
-	float phi = 0, theta = 0;
+#pragma region Dodecahedron
+// Base dodecahedron, 12 pentagons of 3 triangles each, before subdivision.
+static const MeshSize C_DodecahedronBase{ 24, 108 };
+static const uint32_t C_DodecahedronEdges = 59;
+
+MeshSize Learnings::DodecahedronSize(uint16_t subdivide, SubDivideMode mode)
+{
+	return SubDivideSize(C_DodecahedronBase, C_DodecahedronEdges, subdivide, mode);
+}
+
+// Write the 24 vertices and 36 triangles of the base dodecahedron to the front of out
+static void DodecahedronBase(const MeshSpan &out, float radius)
+{
+	SpanWriter shape(out);
+
+	float phi = 0;
 	float dphi_a = Math::XMConvertToRadians(52.62263590f);  // Where do these numbers come from?
 	float dphi_b = Math::XMConvertToRadians(10.81231754f);  // Where do these numbers come from?
 	float dtheta = Math::XM_2PI / 5;
 
-	auto points = [&](int n) {
-		for (int i = 0; i < n; i++)
+	// Rings alternate between starting at 0 and at half a step
+	SinCosRing ring(6, dtheta);
+	SinCosRing halfRing(6, dtheta, dtheta / 2.0f);
+
+	auto points = [&](const SinCosRing &r) {
+		float sinPhi, cosPhi;
+		Math::XMScalarSinCos(&sinPhi, &cosPhi, phi);
+
+		for (int i = 0; i < 6; i++)
 		{
 			float x, y, z;
 			float u, v;
 
-			x = radius * cos(theta) * cos(phi);
-			z = radius * sin(theta) * cos(phi);
-			y = radius * sin(phi);
+			x = radius * r.cos[i] * cosPhi;
+			z = radius * r.sin[i] * cosPhi;
+			y = radius * sinPhi;
 
 			u = atan2(x, z) / (-Math::XM_2PI);
 			if (u < 0.0f) {
@@ -379,9 +779,7 @@ Mesh Learnings::Dodecahedron(float radius, uint16_t subdivide)
 			}
 			v = asin(y) / Math::XM_PI + 0.5f;
 
-			theta += dtheta;
-
-			shape.vertices.push_back({
+			shape.Add({
 				{ x, y, z },{ u, v }
 			});
 
@@ -390,26 +788,22 @@ Mesh Learnings::Dodecahedron(float radius, uint16_t subdivide)
 
 	// 1st Ring
 	phi = dphi_a;
-	theta = 0;
-	points(6);
+	points(ring);
 
 	// 2nd Ring
 	phi = dphi_b;
-	theta = 0;
-	points(6);
+	points(ring);
 
 	// 3rd Ring
 	phi = -dphi_b;
-	theta = dtheta / 2.0f;
-	points(6);
+	points(halfRing);
 
 	// 4th Ring
 	phi = -dphi_a;
-	theta = dtheta / 2.0f;
-	points(6);
+	points(halfRing);
 
-	// Indices 
-	shape.indices = {
+	// Indices
+	shape.Add({
 		1, 0, 2, // North Cap Pentagon
 		2, 0, 3, // North Cap Pentagon
 		3, 0, 4, // North Cap Pentagon
@@ -419,37 +813,291 @@ Mesh Learnings::Dodecahedron(float radius, uint16_t subdivide)
 		9, 2, 3,	 9, 8, 2,	 9, 14, 8, // Ring 1 Pentagons
 		10, 3, 4,	 10, 9, 3,	 10, 15, 9, // Ring 1 Pentagons
 		11, 4, 5,	 11, 10, 4,	 11, 16, 10, // Ring 1 Pentagons
-		
+
 		12, 7, 13,	12, 13, 18,	 18, 13, 19, // Ring 2 Pentagons
 		13, 8, 14,	13, 14, 19,	 19, 14, 20, // Ring 2 Pentagons
 		14, 9, 15,	14, 15, 20,	 20, 15, 21, // Ring 2 Pentagons
 		15, 10, 16,	15, 16, 21,	 21, 16, 22, // Ring 2 Pentagons
 		16, 11, 17,	16, 17, 22,	 22, 17, 23, // Ring 2 Pentagons
-		
+
 		18, 19, 20, // South Cap Pentagon
 		18, 20, 21, // South Cap Pentagon
 		18, 21, 22, // South Cap Pentagon
-	};
+	});
+}
 
-	
-	shape = SubDivideMesh(shape, subdivide);
+void Learnings::Dodecahedron(const MeshSpan &out, float radius, uint16_t subdivide, SubDivideMode mode)
+{
+	MeshSize size = DodecahedronSize(subdivide, mode);
+	CheckSpan(out, size);
 
-	using namespace Math;
-	for (auto &vtx : shape.vertices)
+	DodecahedronBase(out, radius);
+
+	SubDivideMesh(out, C_DodecahedronBase, C_DodecahedronEdges, subdivide, mode);
+
+	ProjectToSphere(out.vertices, size.vertexCount, radius);
+}
+
+Mesh Learnings::Dodecahedron(float radius, uint16_t subdivide, SubDivideMode mode)
+{
+	return MakeMesh([&]() { return DodecahedronSize(subdivide, mode); },
+					[&](const MeshSpan &out) { Dodecahedron(out, radius, subdivide, mode); });
+}
+#pragma endregion
+
+#pragma region Adaptive Sphere
+// Refines a base mesh whose vertices are already on the sphere, one edge at a time.
+// Whether an edge splits depends only on its two end positions, so the triangles on either side
+// of it, and the copies of it along UV seams, always agree and no T-junction can form.
+// A triangle then splits by however many of its edges split: 1 into 2, 2 into 3 and 3 into 4
+class AdaptiveSphere
+{
+public:
+	AdaptiveSphere(const MeshSpan &base, float radius, const AdaptiveView &view)
+		: m_Radius(radius),
+		m_View(view),
+		m_Culler(Math::XMLoadFloat4x4(&view.meshToClip)),
+		m_Vertices(base.vertices, base.vertices + base.vertexCount)
 	{
-		XMVECTOR n = Math::XMVector3Normalize(XMLoadFloat3(&vtx.position));
-		XMVECTOR p = radius * n;
+		const Math::XMFLOAT4X4 &m = view.meshToClip;
 
-		XMStoreFloat3(&vtx.position, p);
+		// Pixels per unit at w = 1, from the lengths of the x and y clip columns
+		float xScale = std::sqrt(m._11 * m._11 + m._21 * m._21 + m._31 * m._31);
+		float yScale = std::sqrt(m._12 * m._12 + m._22 * m._22 + m._32 * m._32);
+		m_PixelScale = 0.5f * std::max(view.viewportWidth * xScale, view.viewportHeight * yScale);
+
+		// Edges stop splitting around the length they would have at maxLevel
+		float longest = 0.0f;
+		for (uint32_t i = 0; i < base.indexCount; i++)
+		{
+			uint32_t i0 = base.indices[i];
+			uint32_t i1 = base.indices[(i % 3 == 2) ? i - 2 : i + 1];
+			longest = std::max(longest, Distance(m_Vertices[i0].position, m_Vertices[i1].position));
+		}
+		m_MinLength = std::ldexp(longest, -static_cast<int>(view.maxLevel));
+
+		for (uint32_t i = 0; i < base.indexCount; i += 3)
+		{
+			Refine(base.indices[i], base.indices[i + 1], base.indices[i + 2], 0);
+		}
 	}
-	
 
-	return shape;
+	Mesh TakeMesh()
+	{
+		Mesh mesh;
+		mesh.vertices = std::move(m_Vertices);
+		mesh.indices = std::move(m_Indices);
+		mesh.indexFormat = IndexFormat(static_cast<uint32_t>(mesh.vertices.size()));
+		mesh.UpdateBounds();
+
+		return mesh;
+	}
+
+private:
+	// Guards against runaway recursion only, edges stop at m_MinLength long before
+	static const uint32_t C_MaxDepth = 64;
+	static const uint32_t C_NoSplit = UINT32_MAX;
+
+	static float Distance(const Math::XMFLOAT3 &a, const Math::XMFLOAT3 &b)
+	{
+		return Math::XMVectorGetX(Math::XMVector3Length(Math::XMVectorSubtract(Math::XMLoadFloat3(&a), Math::XMLoadFloat3(&b))));
+	}
+
+	bool Split(const Vertex &v0, const Vertex &v1) const
+	{
+		Math::XMVECTOR p0 = Math::XMLoadFloat3(&v0.position);
+		Math::XMVECTOR p1 = Math::XMLoadFloat3(&v1.position);
+
+		float chord = Math::XMVectorGetX(Math::XMVector3Length(Math::XMVectorSubtract(p1, p0)));
+		if (chord <= m_MinLength)
+		{
+			return false;
+		}
+
+		Math::XMVECTOR chordMid = Math::XMVectorScale(Math::XMVectorAdd(p0, p1), 0.5f);
+		float midLength = Math::XMVectorGetX(Math::XMVector3Length(chordMid));
+		if (midLength <= 0.0f)
+		{
+			return true;
+		}
+
+		Math::XMVECTOR normal = Math::XMVectorScale(chordMid, 1.0f / midLength);
+		Math::XMVECTOR arcMid = Math::XMVectorScale(normal, m_Radius);
+
+		// The two triangles beside the edge, as a patch that is culled outside the frustum or facing away.
+		// Their normals stay within about the angle the edge spans of the midpoint's
+		float halfAngle = std::asin(std::min(1.0f, 0.5f * chord / m_Radius));
+		Meshlet patch;
+		Math::XMStoreFloat3(&patch.center, arcMid);
+		patch.radius = chord;
+		Math::XMStoreFloat3(&patch.coneAxis, normal);
+		patch.coneCutoff = (halfAngle < Math::XM_PIDIV4) ? std::sin(2.0f * halfAngle) : 1.0f;
+
+		if (!m_Culler.Visible(patch))
+		{
+			return false;
+		}
+
+		// Chord to arc distance, projected as if it lay across the view
+		const Math::XMFLOAT3 &s = patch.center;
+		const Math::XMFLOAT4X4 &m = m_View.meshToClip;
+		float w = s.x * m._14 + s.y * m._24 + s.z * m._34 + m._44;
+		if (w <= 1e-6f)
+		{
+			return true;
+		}
+
+		float sagitta = m_Radius - midLength;
+		return sagitta * m_PixelScale / w > m_View.tolerance;
+	}
+
+	// Shared midpoint of an edge on the sphere, or C_NoSplit when the edge stays whole
+	uint32_t MidPoint(uint32_t i0, uint32_t i1)
+	{
+		auto found = m_MidPoints.find(EdgeKey(i0, i1));
+		if (found != m_MidPoints.end())
+		{
+			return found->second;
+		}
+
+		uint32_t mid = C_NoSplit;
+		if (Split(m_Vertices[i0], m_Vertices[i1]))
+		{
+			if (m_Vertices.size() >= C_StripCut)
+			{
+				throw std::length_error("Adaptive sphere is too large for 32 bit indices");
+			}
+
+			Vertex v = ::MidPoint(m_Vertices[i0], m_Vertices[i1]);
+			Math::XMStoreFloat3(&v.position, Math::XMVectorScale(Math::XMVector3Normalize(Math::XMLoadFloat3(&v.position)), m_Radius));
+
+			mid = static_cast<uint32_t>(m_Vertices.size());
+			m_Vertices.push_back(v);
+		}
+
+		m_MidPoints.insert({ EdgeKey(i0, i1), mid });
+		return mid;
+	}
+
+	float Distance(uint32_t i0, uint32_t i1) const
+	{
+		return Distance(m_Vertices[i0].position, m_Vertices[i1].position);
+	}
+
+	void Refine(uint32_t a, uint32_t b, uint32_t c, uint32_t depth)
+	{
+		uint32_t v[3] = { a, b, c };
+		uint32_t m[3] = { C_NoSplit, C_NoSplit, C_NoSplit };
+		uint32_t splitCount = 0;
+
+		if (depth < C_MaxDepth)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				m[k] = MidPoint(v[k], v[(k + 1) % 3]);
+				splitCount += (m[k] != C_NoSplit) ? 1 : 0;
+			}
+		}
+		assert(depth < C_MaxDepth && "adaptive refinement did not converge");
+
+		depth++;
+		switch (splitCount)
+		{
+			case 0:
+			{
+				m_Indices.insert(m_Indices.end(), { a, b, c });
+				break;
+			}
+
+			case 1:
+			{
+				// Split edge from p to q, halves fan from the opposite corner
+				uint32_t k = (m[0] != C_NoSplit) ? 0 : (m[1] != C_NoSplit) ? 1 : 2;
+				uint32_t p = v[k], q = v[(k + 1) % 3], o = v[(k + 2) % 3];
+
+				Refine(p, m[k], o, depth);
+				Refine(m[k], q, o, depth);
+				break;
+			}
+
+			case 2:
+			{
+				// Whole edge from p to q, cut off the corner o between the split edges
+				// and halve the quad left over along its shorter diagonal
+				uint32_t k = (m[0] == C_NoSplit) ? 0 : (m[1] == C_NoSplit) ? 1 : 2;
+				uint32_t p = v[k], q = v[(k + 1) % 3], o = v[(k + 2) % 3];
+				uint32_t mq = m[(k + 1) % 3], mo = m[(k + 2) % 3];
+
+				Refine(mq, o, mo, depth);
+				if (Distance(p, mq) <= Distance(q, mo))
+				{
+					Refine(p, q, mq, depth);
+					Refine(p, mq, mo, depth);
+				}
+				else
+				{
+					Refine(p, q, mo, depth);
+					Refine(q, mq, mo, depth);
+				}
+				break;
+			}
+
+			default:
+			{
+				Refine(a, m[0], m[2], depth);
+				Refine(m[0], b, m[1], depth);
+				Refine(m[2], m[1], c, depth);
+				Refine(m[0], m[1], m[2], depth);
+				break;
+			}
+		}
+	}
+
+	float m_Radius;
+	AdaptiveView m_View;
+	MeshletCuller m_Culler;
+	float m_PixelScale;
+	float m_MinLength;
+
+	std::vector<Vertex> m_Vertices;
+	std::vector<uint32_t> m_Indices;
+	EdgeMap m_MidPoints;
+};
+
+Mesh Learnings::Icosahedron(float radius, const AdaptiveView &view)
+{
+	Mesh base;
+	MeshSpan out = base.Resize(C_IcosahedronBase);
+	IcosahedronBase(out, radius);
+
+	return AdaptiveSphere(out, radius, view).TakeMesh();
 }
 
-Mesh Learnings::Sphere(float radius, uint16_t slices, uint16_t stacks)
+Mesh Learnings::Dodecahedron(float radius, const AdaptiveView &view)
 {
-	Mesh shape;
+	Mesh base;
+	MeshSpan out = base.Resize(C_DodecahedronBase);
+	DodecahedronBase(out, radius);
+
+	return AdaptiveSphere(out, radius, view).TakeMesh();
+}
+#pragma endregion
+
+#pragma region Sphere
+MeshSize Learnings::SphereSize(uint16_t slices, uint16_t stacks)
+{
+	uint32_t vertexCount = 2u + (stacks - 1u) * slices;
+	uint32_t indexCount = 3u * slices		// North Pole
+		+ 6u * slices * (stacks - 2u)		// Stuff inbetween
+		+ 3u * slices;						// South Pole
+
+	return{ vertexCount, indexCount };
+}
+
+void Learnings::Sphere(const MeshSpan &out, float radius, uint16_t slices, uint16_t stacks, uint32_t threadCount)
+{
+	MeshSize size = SphereSize(slices, stacks);
+	CheckSpan(out, size);
 
 	float r = radius;
 	float dp = Math::XM_PI / stacks;
@@ -458,91 +1106,152 @@ Mesh Learnings::Sphere(float radius, uint16_t slices, uint16_t stacks)
 	float du = 1.0f / slices;
 	float dv = 1.0f / stacks;
 
-	shape.vertices.push_back(Vertex{
-		{0.0f, r, 0.0f}, { 0.0f, 0.0f }
-	});
+	uint32_t spIdx = size.vertexCount - 1;
 
-	for (uint32_t stack = 1; stack < stacks; stack++)
-	{
-		float v = dv * stack;
-		float phi = stack * dp;
+	// Same theta for every stack, so sin/cos are computed once
+	SinCosRing ring(slices, dt);
 
-		for (uint32_t slice = 0; slice < slices; slice++)
+	// Poles
+	out.vertices[0] = Vertex{
+		{ 0.0f, r, 0.0f },{ 0.0f, 0.0f }
+	};
+	out.vertices[spIdx] = Vertex{
+		{ 0.0f, -r, 0.0f },{ 0.0f, 1.0f }
+	};
+
+	// Rings, each stack writes its own vertex row and the band of faces below it
+	// so rows can be generated on any thread in any order.
+	ParallelFor(stacks - 1u, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t row = begin; row < end; row++)
 		{
-			float theta = slice * dt;
+			uint32_t stack = row + 1;
+			float v = dv * stack;
+			float phi = stack * dp;
 
-			float x, y, z;
-			x = r * std::sinf(phi) * std::cosf(theta);
-			y = r * std::cosf(phi);
-			z = r * std::sinf(phi) * std::sinf(theta);
+			float sinPhi, cosPhi;
+			Math::XMScalarSinCos(&sinPhi, &cosPhi, phi);
 
-			
-			float u;
-			u = du * slice;
+			float rs = r * sinPhi;
+			float y = r * cosPhi;
 
-			shape.vertices.push_back(Vertex{
-				{ x, y, z },{ u, v }
-			});
+			Vertex *vtx = out.vertices + 1 + row * slices;
+			for (uint32_t slice = 0; slice < slices; slice++)
+			{
+				float x, z;
+				x = rs * ring.cos[slice];
+				z = rs * ring.sin[slice];
+
+
+				float u;
+				u = du * slice;
+
+				vtx[slice] = Vertex{
+					{ x, y, z },{ u, v }
+				};
+			}
+
+			// Faces for Stuff inbetween
+			if (row >= stacks - 2u)
+			{
+				continue;
+			}
+
+			uint32_t offset = row * slices + 1;
+			uint32_t *idx = out.indices + 3u * slices + 6u * slices * row;
+			for (uint32_t i = 0; i < slices; i++)
+			{
+				bool lastSlice = (i == slices - 1u);
+
+				*idx++ = offset + i;
+				*idx++ = (lastSlice) ? offset : offset + i + 1;
+				*idx++ = offset + i + slices;
+
+				*idx++ = offset + i + slices;
+				*idx++ = (lastSlice) ? offset : offset + i + 1;
+				*idx++ = (lastSlice) ? offset + slices : offset + i + 1 + slices;
+			}
 		}
-	}
-	shape.vertices.push_back(Vertex{
-		{ 0.0f, -r, 0.0f },{ 0.0f, 1.0f }
 	});
 
 	// Faces for North Pole
+	uint32_t *idx = out.indices;
 	for (uint32_t i = 1; i <= slices; i++)
 	{
-		shape.indices.insert(shape.indices.end(), {
-			0, 
-			(i == slices) ? 1 : i + 1,
-			i
-		});
+		*idx++ = 0;
+		*idx++ = (i == slices) ? 1 : i + 1;
+		*idx++ = i;
 	}
 
-	// Faces for Stuff inbetween
-	for (uint32_t j = 0; j < stacks - 2u; j++)
+	// Faces for South Pole
+	idx = out.indices + size.indexCount - 3u * slices;
+	uint32_t spOffset = spIdx - slices - 1;
+	for (uint32_t i = 1; i <= slices; i++)
 	{
-		uint32_t offset = j * slices + 1;
-		for (uint32_t i = 0; i < slices; i++)
-		{
-			bool lastSlice = !((offset + i) < ((j + 1) * slices));
-			shape.indices.insert(shape.indices.end(), {
-				offset + i,
-				(lastSlice) ? offset : offset + i + 1,
-				offset + i + slices
-			});
+		uint32_t n = spOffset + i;
+		*idx++ = spIdx;
+		*idx++ = n;
+		*idx++ = (i == slices) ? spOffset + 1 : n + 1;
+	}
+}
 
-			shape.indices.insert(shape.indices.end(), {
-				offset + i + slices,
-				(lastSlice) ? offset : offset + i + 1,
-				(lastSlice) ? offset + slices : offset + i + 1 + slices
-			});
-		}
+Mesh Learnings::Sphere(float radius, uint16_t slices, uint16_t stacks, uint32_t threadCount)
+{
+	return MakeMesh([&]() { return SphereSize(slices, stacks); },
+					[&](const MeshSpan &out) { Sphere(out, radius, slices, stacks, threadCount); });
+}
+#pragma endregion
+
+#pragma region Cylinder
+MeshSize Learnings::CylinderSize(uint16_t slices, bool cap, PrimitiveMode mode)
+{
+	// Not just an assert, a release build would hand back a triangle list tagged as lines
+	if (mode == PrimitiveMode::LineList)
+	{
+		throw std::invalid_argument("Cylinder has no line mode");
 	}
+	bool strip = (mode == PrimitiveMode::TriangleStrip);
 
-	// Faces for South Pole
-	uint32_t spIdx = static_cast<uint32_t>(shape.vertices.size() - 1);
-	uint32_t spOffset = spIdx - slices - 1;
-	for (uint32_t i = 1; i <= slices; i++)
+	uint32_t vertexCount = 2u * (slices + 1u);	// Body
+	uint32_t indexCount = strip ? 2u * (slices + 1u) : 6u * slices;
+
+	if (cap)
 	{
-		uint32_t idx = spOffset + i;
-		shape.indices.insert(shape.indices.end(), {
-			spIdx,
-			(i == slices) ? idx : idx,
-			(i == slices) ? spOffset + 1 : idx + 1
-		});
+		vertexCount += 2u * slices;
+		// Strip caps visit each ring vertex once and end in a cut
+		indexCount += strip ? 2u * (slices + 1u) : 2u * 3u * (slices - 2u);
 	}
 
-	return shape;
+	return{ vertexCount, indexCount };
 }
 
-Mesh Learnings::Cylinder(float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap)
+// Convex ring of slices vertices from first as one strip, zigzagging across it from vertex 0.
+// Goes to the last vertex before the second unless ascending, which flips the winding
+static void CapStrip(SpanWriter &shape, uint32_t first, uint16_t slices, bool ascending)
 {
-	Mesh shape;
+	for (uint32_t k = 0; k < slices; k++)
+	{
+		uint32_t step = (k + 1u) / 2u;
+		bool fromEnd = (k % 2u == 1u) != ascending;
+
+		shape.Add({ first + ((k == 0 || !fromEnd) ? step : slices - step) });
+	}
+
+	shape.Add({ C_StripCut });
+}
+
+void Learnings::Cylinder(const MeshSpan &out, float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap, PrimitiveMode mode)
+{
+	CheckSpan(out, CylinderSize(slices, cap, mode));
+	SpanWriter shape(out);
+	bool strip = (mode == PrimitiveMode::TriangleStrip);
 
 	float h = height / 2.0f;
 	float angle = Math::XM_2PI / slices;
-	
+
+	// One table for caps and body, body needs the closing seam at 2 pi as well
+	SinCosRing ring(slices + 1u, angle);
+
 	uint32_t cnt = 0;
 	// Cap
 	if (cap)
@@ -553,52 +1262,66 @@ Mesh Learnings::Cylinder(float radiusTop, float radiusBottom, float height, uint
 			float x, y, z;
 			float u, v;
 
-			x = radiusTop * std::cosf(i * angle);
-			z = radiusTop * std::sinf(i * angle);
+			x = radiusTop * ring.cos[i];
+			z = radiusTop * ring.sin[i];
 			y = h;
 
-			u = 0.25f * std::cosf(i * angle) + 0.25f;
-			v = 0.25f * std::sinf(i * angle) + 0.25f;
+			u = 0.25f * ring.cos[i] + 0.25f;
+			v = 0.25f * ring.sin[i] + 0.25f;
 
-			shape.vertices.push_back(Vertex{ { x, y, z },{ u, v } });
+			shape.Add(Vertex{ { x, y, z },{ u, v } });
 		}
 
-		for (uint16_t i = 1; i < slices - 1; i++)
+		if (strip)
 		{
-			uint32_t n = i;
-			shape.indices.insert(shape.indices.end(), {
-				n + 1, n, 0
-			});
+			CapStrip(shape, 0, slices, false);
+		}
+		else
+		{
+			for (uint16_t i = 1; i < slices - 1; i++)
+			{
+				uint32_t n = i;
+				shape.Add({
+					n + 1, n, 0
+				});
+			}
 		}
-		
 
-		cnt = static_cast<uint32_t>(shape.vertices.size());
-		
+
+		cnt = slices;
+
 		// Bottom
 		for (uint16_t i = 0; i < slices; i++)
 		{
 			float x, y, z;
 			float u, v;
 
-			x = radiusBottom * std::cosf(i * angle);
-			z = radiusBottom * std::sinf(i * angle);
+			x = radiusBottom * ring.cos[i];
+			z = radiusBottom * ring.sin[i];
 			y = -h;
 
-			u = 0.25f * std::cosf(i * angle) + 0.75f;
-			v = 0.25f * std::sinf(i * angle) + 0.25f;
+			u = 0.25f * ring.cos[i] + 0.75f;
+			v = 0.25f * ring.sin[i] + 0.25f;
 
-			shape.vertices.push_back(Vertex{ { x, y, z },{ u, v } });
+			shape.Add(Vertex{ { x, y, z },{ u, v } });
 		}
 
-		for (uint16_t i = 1; i < slices - 1; i++)
+		if (strip)
 		{
-			uint32_t n = i + cnt;
-			shape.indices.insert(shape.indices.end(), {
-				cnt, n, n + 1
-			});
+			CapStrip(shape, cnt, slices, true);
+		}
+		else
+		{
+			for (uint16_t i = 1; i < slices - 1; i++)
+			{
+				uint32_t n = i + cnt;
+				shape.Add({
+					cnt, n, n + 1
+				});
+			}
 		}
 
-		cnt = static_cast<uint32_t>(shape.vertices.size());
+		cnt = 2u * slices;
 	}
 
 	// Body
@@ -609,64 +1332,179 @@ Mesh Learnings::Cylinder(float radiusTop, float radiusBottom, float height, uint
 		float v = cap ? 0.5f : 0.0f;
 
 		// Top
-		x = radiusTop * std::cosf(i * angle);
-		z = radiusTop * std::sinf(i * angle);
+		x = radiusTop * ring.cos[i];
+		z = radiusTop * ring.sin[i];
 		y = h;
 
-		shape.vertices.push_back(Vertex{ {x, y, z}, {u, v} });
+		shape.Add(Vertex{ {x, y, z}, {u, v} });
 
 		// Bottom
-		x = radiusBottom * std::cosf(i * angle);
-		z = radiusBottom * std::sinf(i * angle);
+		x = radiusBottom * ring.cos[i];
+		z = radiusBottom * ring.sin[i];
 		y = -h;
 
-		shape.vertices.push_back(Vertex{ { x, y, z },{ u, 1.0f } });
+		shape.Add(Vertex{ { x, y, z },{ u, 1.0f } });
+	}
+
+	if (strip)
+	{
+		// Bottom first, so the first triangle winds like the list's
+		for (uint16_t i = 0; i <= slices; i++)
+		{
+			uint32_t n = i * 2 + cnt;
+			shape.Add({ n + 1, n });
+		}
+		return;
 	}
 
 	for (uint16_t i = 0; i < slices; i++)
 	{
 		uint32_t n = i * 2 + cnt;
-		shape.indices.insert(shape.indices.end(), {
+		shape.Add({
 			n, n + 2, n + 1,
 			n + 1, n + 2, n + 3
 		});
 	}
+}
+
+Mesh Learnings::Cylinder(float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap, PrimitiveMode mode)
+{
+	Mesh shape = MakeMesh([&]() { return CylinderSize(slices, cap, mode); },
+						  [&](const MeshSpan &out) { Cylinder(out, radiusTop, radiusBottom, height, slices, cap, mode); });
+	shape.topology = Topology(mode);
 
 	return shape;
 }
+#pragma endregion
 
-Mesh Learnings::Grid(float cellSize, uint16_t cellCount)
+#pragma region Grid
+MeshSize Learnings::GridSize(uint16_t cellCount, PrimitiveMode mode)
 {
-	auto startPos = cellSize * cellCount / 2.0f;
+	uint64_t rowLength = cellCount + 1u;
 
-	Mesh grid;
-	for (auto i = 0; i <= cellCount; i++)
+	if (mode == PrimitiveMode::LineList)
 	{
-		uint32_t vertexIdx = (uint32_t)grid.vertices.size();
-		grid.indices.insert(grid.indices.end(),
-		{ 
-			vertexIdx, vertexIdx + 1,		// X direction
-			vertexIdx + 2, vertexIdx + 3	// Z direction
-		});
+		return{ static_cast<uint32_t>(rowLength * 4u), static_cast<uint32_t>(rowLength * 4u) };
+	}
 
-		float xx1, xy1, xx2, xy2;	// X direction
-		float zx1, zy1, zx2, zy2;	// Z direction
+	// One vertex per lattice point, one list or strip per row of cells. Strips are cut between rows
+	uint64_t vertexCount = rowLength * rowLength;
+	uint64_t indexCount = (mode == PrimitiveMode::TriangleStrip)
+		? (cellCount > 0 ? cellCount * (2u * rowLength + 1u) - 1u : 0u)
+		: 6u * static_cast<uint64_t>(cellCount) * cellCount;
 
-		xx1 = -startPos + (i * cellSize); xy1 = -startPos;
-		xx2 = -startPos + (i * cellSize); xy2 = startPos;
+	// Largest index must stay clear of the cut value
+	if (vertexCount >= C_StripCut || indexCount > UINT32_MAX)
+	{
+		throw std::length_error("Grid is too large for 32 bit indices");
+	}
 
-		zx1 = -startPos; zy1 = -startPos + (i * cellSize);
-		zx2 = startPos; zy2 = -startPos + (i * cellSize);
+	return{ static_cast<uint32_t>(vertexCount), static_cast<uint32_t>(indexCount) };
+}
 
-		grid.vertices.insert(grid.vertices.end(), 
+// Filled grid, each row of lattice points owns its vertices and the cells above it, so rows split across threads
+static void FilledGrid(const MeshSpan &out, float cellSize, uint16_t cellCount, uint32_t threadCount, bool strip)
+{
+	uint32_t rowLength = cellCount + 1u;
+	float startPos = cellSize * cellCount / 2.0f;
+	float uvStep = (cellCount > 0) ? 1.0f / cellCount : 0.0f;
+
+	ParallelFor(rowLength, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t j = begin; j < end; j++)
 		{
-			{ { xx1, 0.0f, xy1 }, { 0.0f, 0.0f } }, 
-			{ { xx2, 0.0f, xy2 }, { 0.0f, 0.0f } },
+			uint32_t lower = j * rowLength;
+			uint32_t upper = lower + rowLength;
+			float z = -startPos + j * cellSize;
 
-			{ { zx1, 0.0f, zy1 }, { 0.0f, 0.0f } }, 
-			{ { zx2, 0.0f, zy2 }, { 0.0f, 0.0f } },
-		});
+			Vertex *vtx = out.vertices + lower;
+			for (uint32_t i = 0; i < rowLength; i++)
+			{
+				vtx[i] = { { -startPos + i * cellSize, 0.0f, z }, { i * uvStep, j * uvStep } };
+			}
+
+			if (j == cellCount)
+			{
+				continue;
+			}
+
+			if (strip)
+			{
+				// Lower row first so the first triangle faces +Y like the list's
+				uint32_t *idx = out.indices + j * (2u * rowLength + 1u);
+				for (uint32_t i = 0; i < rowLength; i++)
+				{
+					*idx++ = lower + i;
+					*idx++ = upper + i;
+				}
+
+				if (j + 1u < cellCount)
+				{
+					*idx = C_StripCut;
+				}
+			}
+			else
+			{
+				uint32_t *idx = out.indices + j * 6u * cellCount;
+				for (uint32_t i = 0; i < cellCount; i++)
+				{
+					uint32_t v00 = lower + i, v01 = upper + i;
+					idx[0] = v00; idx[1] = v01; idx[2] = v00 + 1;
+					idx[3] = v00 + 1; idx[4] = v01; idx[5] = v01 + 1;
+					idx += 6;
+				}
+			}
+		}
+	});
+}
+
+void Learnings::Grid(const MeshSpan &out, float cellSize, uint16_t cellCount, uint32_t threadCount, PrimitiveMode mode)
+{
+	CheckSpan(out, GridSize(cellCount, mode));
+
+	if (mode != PrimitiveMode::LineList)
+	{
+		FilledGrid(out, cellSize, cellCount, threadCount, mode == PrimitiveMode::TriangleStrip);
+		return;
 	}
 
-	return grid;
+	auto startPos = cellSize * cellCount / 2.0f;
+
+	// Each line pair owns 4 vertices and 4 indices, so rows split cleanly across threads
+	ParallelFor(cellCount + 1u, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			uint32_t vertexIdx = i * 4u;
+			uint32_t *idx = out.indices + vertexIdx;
+			idx[0] = vertexIdx; idx[1] = vertexIdx + 1;		// X direction
+			idx[2] = vertexIdx + 2; idx[3] = vertexIdx + 3;	// Z direction
+
+			float xx1, xy1, xx2, xy2;	// X direction
+			float zx1, zy1, zx2, zy2;	// Z direction
+
+			xx1 = -startPos + (i * cellSize); xy1 = -startPos;
+			xx2 = -startPos + (i * cellSize); xy2 = startPos;
+
+			zx1 = -startPos; zy1 = -startPos + (i * cellSize);
+			zx2 = startPos; zy2 = -startPos + (i * cellSize);
+
+			Vertex *vtx = out.vertices + vertexIdx;
+			vtx[0] = { { xx1, 0.0f, xy1 }, { 0.0f, 0.0f } };
+			vtx[1] = { { xx2, 0.0f, xy2 }, { 0.0f, 0.0f } };
+
+			vtx[2] = { { zx1, 0.0f, zy1 }, { 0.0f, 0.0f } };
+			vtx[3] = { { zx2, 0.0f, zy2 }, { 0.0f, 0.0f } };
+		}
+	});
+}
+
+Mesh Learnings::Grid(float cellSize, uint16_t cellCount, uint32_t threadCount, PrimitiveMode mode)
+{
+	Mesh shape = MakeMesh([&]() { return GridSize(cellCount, mode); },
+						  [&](const MeshSpan &out) { Grid(out, cellSize, cellCount, threadCount, mode); });
+	shape.topology = Topology(mode);
+
+	return shape;
 }
+#pragma endregion
@@ -1,19 +1,84 @@
 #pragma once
 
 #include <cstdint>
+#include <DirectXMath.h>
 
 namespace Learnings
 {
 	struct Mesh;
+	struct MeshSize;
+	struct MeshSpan;
+
+	enum class SubDivideMode
+	{
+		Split,	// every triangle gets its own 6 vertices
+		Shared	// edge midpoints are shared between neighbouring triangles
+	};
+
+	// How a generator lays out its index list, the Mesh overloads set the matching topology.
+	// A generator without a mode throws std::invalid_argument for it
+	enum class PrimitiveMode
+	{
+		LineList,
+		TriangleList,
+		TriangleStrip	// strips separated by C_StripCut, about a third of the list's indices
+	};
+
+	// Camera and error bound an adaptive sphere is refined for
+	struct AdaptiveView
+	{
+		DirectX::XMFLOAT4X4 meshToClip;	// world * view * projection, not transposed
+		float viewportWidth;
+		float viewportHeight;
+		float tolerance;				// pixels the facets may stray from the true sphere
+		uint16_t maxLevel;				// finest refinement, as a uniform subdivide level
+	};
+
+	// Counting pass
+	MeshSize TriangleSize();
+	MeshSize RectangleSize();
+	MeshSize BoxSize();
+	MeshSize TetrahedronSize();
+	MeshSize OctahedronSize();
+	MeshSize IcosahedronSize(uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+	MeshSize DodecahedronSize(uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+	MeshSize GeodesicSphereSize(uint16_t frequency);
+	MeshSize SphereSize(uint16_t slices, uint16_t stacks);
+	MeshSize CylinderSize(uint16_t slices, bool cap, PrimitiveMode mode = PrimitiveMode::TriangleList);
+	MeshSize GridSize(uint16_t cellCount, PrimitiveMode mode = PrimitiveMode::LineList);
+
+	// Fill pass
+	// threadCount splits rows across worker threads, 0 uses every hardware thread.
+	// Output does not depend on threadCount.
+	void Triangle(const MeshSpan &out, float base, float height, float tipOffset);
+	void Rectangle(const MeshSpan &out, float length, float width);
+	void Box(const MeshSpan &out, float length, float width, float height);
+	void Tetrahedron(const MeshSpan &out, float radius);
+	void Octahedron(const MeshSpan &out, float radius);
+	void Icosahedron(const MeshSpan &out, float radius, uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+	void Dodecahedron(const MeshSpan &out, float radius, uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+	void GeodesicSphere(const MeshSpan &out, float radius, uint16_t frequency);
+	void Sphere(const MeshSpan &out, float radius, uint16_t slices, uint16_t stacks, uint32_t threadCount = 1);
+	// TriangleStrip draws the body as one strip and each cap as a zigzag strip
+	void Cylinder(const MeshSpan &out, float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap, PrimitiveMode mode = PrimitiveMode::TriangleList);
+	// LineList is the wireframe lattice, the triangle modes a filled XZ plane facing +Y with one strip per row
+	void Grid(const MeshSpan &out, float cellSize, uint16_t cellCount, uint32_t threadCount = 1, PrimitiveMode mode = PrimitiveMode::LineList);
 
 	Mesh Triangle(float base, float height, float tipOffset);
 	Mesh Rectangle(float length, float width);
 	Mesh Box(float length, float width, float height);
 	Mesh Tetrahedron(float radius);
 	Mesh Octahedron(float radius);
-	Mesh Icosahedron(float radius, uint16_t subdivide);
-	Mesh Dodecahedron(float radius, uint16_t subdivide);
-	Mesh Sphere(float radius, uint16_t slices, uint16_t stacks);
-	Mesh Cylinder(float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap);
-	Mesh Grid(float cellSize, uint16_t cellCount);
+	Mesh Icosahedron(float radius, uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+	Mesh Dodecahedron(float radius, uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+	// Adaptive mode, edges split only where they stray more than view.tolerance pixels from the sphere,
+	// so faces far away, outside the frustum or facing away stay coarse. Neighbours always agree on
+	// their shared edges and fill the T-junctions with 1 to 2 and 1 to 3 splits, so there are no cracks.
+	// The result has no size up front, so there is only a Mesh overload
+	Mesh Icosahedron(float radius, const AdaptiveView &view);
+	Mesh Dodecahedron(float radius, const AdaptiveView &view);
+	Mesh GeodesicSphere(float radius, uint16_t frequency);
+	Mesh Sphere(float radius, uint16_t slices, uint16_t stacks, uint32_t threadCount = 1);
+	Mesh Cylinder(float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap, PrimitiveMode mode = PrimitiveMode::TriangleList);
+	Mesh Grid(float cellSize, uint16_t cellCount, uint32_t threadCount = 1, PrimitiveMode mode = PrimitiveMode::LineList);
 }
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include "Benchmark.h"
+
+#include "Mesh.h"
+#include "BasicShapes.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshNormals.h"
+#include "HalfEdgeMesh.h"
+#include "MarchingCubes.h"
+#include "Terrain.h"
+#include "Clipmap.h"
+
+using namespace Learnings;
+
+// Best of several runs, in milliseconds
+static double TimeIt(const std::function<void()> &fn, uint32_t runs = 5)
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	double best = 0.0;
+	for (uint32_t i = 0; i < runs; i++)
+	{
+		auto start = Clock::now();
+		fn();
+		std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+		if (i == 0 || elapsed.count() < best)
+		{
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+// Thread counts 1, 2, 4, ... up to and including hardware concurrency
+static std::vector<uint32_t> ThreadCounts()
+{
+	uint32_t hwThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<uint32_t> counts;
+	for (uint32_t t = 1; t < hwThreads; t *= 2)
+	{
+		counts.push_back(t);
+	}
+	counts.push_back(hwThreads);
+
+	return counts;
+}
+
+// One line per thread count, with the speedup over a single thread
+static void ReportScaling(std::ostringstream &report, const std::function<void(uint32_t)> &work)
+{
+	double serial = 0.0;
+	for (auto threads : ThreadCounts())
+	{
+		double ms = TimeIt([&]() { work(threads); });
+		if (threads == 1)
+		{
+			serial = ms;
+		}
+
+		report << "  threads " << std::setw(3) << threads
+			<< ": " << std::fixed << std::setprecision(2) << std::setw(9) << ms << " ms"
+			<< "  x" << std::setprecision(2) << (serial / ms) << "\n";
+	}
+}
+
+// Generate into memory allocated up front, so only generation is timed
+static void BenchmarkScaling(std::ostringstream &report, const std::string &name, const MeshSize &size, const std::function<void(const MeshSpan &, uint32_t)> &generator)
+{
+	Mesh mesh;
+	MeshSpan out = mesh.Resize(size);
+
+	report << name << " (" << size.vertexCount << " vertices, " << size.indexCount << " indices)\n";
+	ReportScaling(report, [&](uint32_t threads) { generator(out, threads); });
+}
+
+std::string Learnings::BenchmarkShapes()
+{
+	std::ostringstream report;
+
+	const uint16_t slices = 2048, stacks = 2048;
+	BenchmarkScaling(report, "Sphere 2048x2048", SphereSize(slices, stacks), [&](const MeshSpan &out, uint32_t threads)
+	{
+		Sphere(out, 1.0f, slices, stacks, threads);
+	});
+
+	const uint16_t cells = 65535;
+	BenchmarkScaling(report, "Grid 65535", GridSize(cells), [&](const MeshSpan &out, uint32_t threads)
+	{
+		Grid(out, 0.01f, cells, threads);
+	});
+
+	// Frames go into memory allocated up front too, only the per-thread sums are allocated while timing
+	Mesh lit = Icosahedron(1.0f, 8);
+	std::vector<TangentFrame> frames(lit.vertices.size());
+	MeshSpan litSpan{
+		lit.vertices.data(), static_cast<uint32_t>(lit.vertices.size()),
+		lit.indices.data(), static_cast<uint32_t>(lit.indices.size())
+	};
+
+	report << "Tangent frames Icosahedron 8 (" << litSpan.indexCount / 3 << " triangles)\n";
+	ReportScaling(report, [&](uint32_t threads) { ComputeTangentFrames(litSpan, frames.data(), threads); });
+
+	// Adaptive sphere seen from close by, against uniform subdivision at its finest level
+	AdaptiveView view;
+	DirectX::XMStoreFloat4x4(&view.meshToClip,
+							 DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 0.0f, -1.2f, 1.0f), DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))
+							 * DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.01f, 100.0f));
+	view.viewportWidth = 1280.0f;
+	view.viewportHeight = 720.0f;
+	view.tolerance = 1.0f;
+	view.maxLevel = 10;
+
+	Mesh adaptive;
+	double adaptiveMs = TimeIt([&]() { adaptive = Icosahedron(1.0f, view); });
+	report << "Adaptive Icosahedron, 1 px at 1280x720 from 1.2 radii  " << adaptive.indices.size() / 3 << " triangles"
+		<< " (uniform level " << view.maxLevel << ": " << IcosahedronSize(view.maxLevel).indexCount / 3 << ")"
+		<< std::fixed << std::setprecision(2) << "  (" << adaptiveMs << " ms)\n";
+
+	// Three metaballs, sum of r^2 / d^2 falloffs, sampled four corners a call
+	const VolumeGrid volume = { { -1.5f, -1.5f, -1.5f }, 3.0f / 256, 256, 256, 256 };
+	VolumeFunction metaballs = [](DirectX::FXMVECTOR x, DirectX::FXMVECTOR y, DirectX::FXMVECTOR z)
+	{
+		const float centres[3][3] = { { -0.5f, 0.0f, 0.0f }, { 0.5f, 0.2f, 0.0f }, { 0.0f, -0.4f, 0.4f } };
+
+		DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+		for (auto &c : centres)
+		{
+			DirectX::XMVECTOR dx = DirectX::XMVectorSubtract(x, DirectX::XMVectorReplicate(c[0]));
+			DirectX::XMVECTOR dy = DirectX::XMVectorSubtract(y, DirectX::XMVectorReplicate(c[1]));
+			DirectX::XMVECTOR dz = DirectX::XMVectorSubtract(z, DirectX::XMVectorReplicate(c[2]));
+			DirectX::XMVECTOR d2 = DirectX::XMVectorMultiplyAdd(dx, dx, DirectX::XMVectorMultiplyAdd(dy, dy, DirectX::XMVectorMultiply(dz, dz)));
+			sum = DirectX::XMVectorAdd(sum, DirectX::XMVectorReciprocal(DirectX::XMVectorMax(d2, DirectX::XMVectorReplicate(1e-6f))));
+		}
+
+		// Inside is below the iso value, so negate the falloff
+		return DirectX::XMVectorScale(sum, -0.16f);
+	};
+
+	Mesh blobs;
+	report << "MarchingCubes metaballs 256^3\n";
+	ReportScaling(report, [&](uint32_t threads) { blobs = MarchingCubes(volume, metaballs, -1.0f, threads); });
+	report << "  " << blobs.vertices.size() << " vertices, " << blobs.indices.size() / 3 << " triangles\n";
+
+	// Fly over rolling hills, waiting for each view to finish streaming before the next
+	const TerrainSettings terrain = { 32.0f, 64, 6, 2.0f, 2000.0f, 2.0f, 64u << 20, 0 };
+	HeightFunction hills = [](DirectX::FXMVECTOR x, DirectX::FXMVECTOR z)
+	{
+		DirectX::XMVECTOR sx = DirectX::XMVectorSin(DirectX::XMVectorScale(x, 0.013f));
+		DirectX::XMVECTOR cz = DirectX::XMVectorCos(DirectX::XMVectorScale(z, 0.011f));
+		return DirectX::XMVectorScale(DirectX::XMVectorMultiply(sx, cz), 40.0f);
+	};
+
+	TerrainStreamer streamer(terrain, hills);
+	const uint32_t steps = 64;
+	double streamMs = TimeIt([&]()
+	{
+		for (uint32_t step = 0; step < steps; step++)
+		{
+			streamer.Update({ step * 100.0f, 50.0f, step * 25.0f });
+			streamer.Flush();
+		}
+	}, 1);
+	report << "Terrain " << steps << " views, " << TerrainTileSize(terrain).indexCount / 3 << " triangles a tile  "
+		<< streamer.GenerateCount() << " generated, " << streamer.EvictCount() << " evicted, "
+		<< streamer.ResidentCount() << " resident in " << streamer.ResidentBytes() / (1024 * 1024) << " MB"
+		<< std::fixed << std::setprecision(2) << "  (" << streamMs << " ms)\n";
+
+	// Clipmap placement per frame grows with levels only, whatever ground it covers
+	std::vector<ClipmapInstance> placements;
+	for (uint32_t levels : { 4u, 8u, 16u })
+	{
+		const ClipmapSettings clipmap = { 1.0f, 63, levels };
+
+		uint64_t vertexCount = 0;
+		for (uint32_t p = 0; p < static_cast<uint32_t>(ClipmapPiece::Count); p++)
+		{
+			auto piece = static_cast<ClipmapPiece>(p);
+			vertexCount += static_cast<uint64_t>(ClipmapPieceMesh(clipmap, piece).vertices.size()) * ClipmapInstanceCount(clipmap, piece);
+		}
+
+		const uint32_t frames = 1000;
+		double placeMs = TimeIt([&]()
+		{
+			for (uint32_t frame = 0; frame < frames; frame++)
+			{
+				PlaceClipmap(clipmap, { frame * 3.7f, 20.0f, frame * 1.3f }, placements);
+			}
+		});
+		report << "Clipmap " << levels << " levels, " << placements.size() << " instances, " << vertexCount << " vertices, "
+			<< ((4ull * clipmap.blockCells + 2ull) << (levels - 1)) << " finest cells across"
+			<< std::fixed << std::setprecision(4) << "  (" << placeMs / frames << " ms a frame)\n";
+	}
+
+	return report.str();
+}
+
+static void ReportOptimization(std::ostringstream &report, const std::string &name, Mesh mesh)
+{
+	auto cacheBefore = AnalyzeVertexCache(mesh);
+	auto fetchBefore = AnalyzeVertexFetch(mesh);
+
+	double cacheMs = TimeIt([&]() { OptimizeVertexCache(mesh); }, 1);
+	auto cacheAfter = AnalyzeVertexCache(mesh);
+	auto fetchCacheOnly = AnalyzeVertexFetch(mesh);
+
+	double fetchMs = TimeIt([&]() { OptimizeVertexFetch(mesh); }, 1);
+	auto fetchAfter = AnalyzeVertexFetch(mesh);
+
+	report << name << "\n" << std::fixed << std::setprecision(3)
+		<< "  cache  ACMR " << cacheBefore.acmr << " -> " << cacheAfter.acmr
+		<< "  ATVR " << cacheBefore.atvr << " -> " << cacheAfter.atvr
+		<< std::setprecision(2) << "  (" << cacheMs << " ms)\n"
+		<< std::setprecision(3)
+		<< "  fetch  overfetch " << fetchBefore.overfetch << " -> " << fetchCacheOnly.overfetch << " -> " << fetchAfter.overfetch
+		<< "  KB " << fetchBefore.bytesFetched / 1024 << " -> " << fetchAfter.bytesFetched / 1024
+		<< std::setprecision(2) << "  (" << fetchMs << " ms)\n";
+}
+
+std::string Learnings::ReportMeshOptimization()
+{
+	std::ostringstream report;
+
+	report << "Post-transform cache " << C_VertexCacheSize << " entry FIFO, fetch cache "
+		<< C_FetchCacheLines << " x " << C_FetchLineSize << " byte lines\n"
+		<< "Overfetch is shown as generated -> cache optimized -> fetch optimized\n";
+	ReportOptimization(report, "Icosahedron 5", Icosahedron(1.0f, 5));
+	ReportOptimization(report, "Dodecahedron 4", Dodecahedron(1.0f, 4));
+	ReportOptimization(report, "GeodesicSphere 50", GeodesicSphere(1.0f, 50));
+	ReportOptimization(report, "Sphere 200x200", Sphere(1.0f, 200, 200));
+	ReportOptimization(report, "Cylinder 64", Cylinder(0.5f, 0.5f, 1.0f, 64, true));
+
+	// Strips carry the same triangles in about a third of the indices
+	report << "Strip indices  Grid 256 " << GridSize(256, PrimitiveMode::TriangleList).indexCount
+		<< " -> " << GridSize(256, PrimitiveMode::TriangleStrip).indexCount
+		<< "  Cylinder 64 " << CylinderSize(64, true).indexCount
+		<< " -> " << CylinderSize(64, true, PrimitiveMode::TriangleStrip).indexCount << "\n";
+
+	// Split subdivision duplicates every shared vertex, welding should give back the shared count
+	Mesh split = Icosahedron(1.0f, 6, SubDivideMode::Split);
+	uint32_t splitCount = (uint32_t)split.vertices.size();
+	uint32_t weldedCount = 0;
+	double weldMs = TimeIt([&]() { weldedCount = WeldVertices(split); }, 1);
+
+	report << "Weld Icosahedron 6 split  " << splitCount << " -> " << weldedCount << " vertices"
+		<< " (shared " << IcosahedronSize(6).vertexCount << ")"
+		<< std::fixed << std::setprecision(2) << "  (" << weldMs << " ms)\n";
+
+	// LOD chain, error is the distance to the original surface in units of the radius
+	Mesh sphere = Icosahedron(1.0f, 5);
+	std::vector<MeshLod> lods;
+	double lodMs = TimeIt([&]() { lods = BuildLods(sphere, { 0.5f, 0.25f, 0.125f, 0.0625f }); }, 1);
+
+	report << "LODs Icosahedron 5  " << sphere.indices.size() / 3 << " triangles"
+		<< std::fixed << std::setprecision(2) << "  (" << lodMs << " ms)\n";
+	for (auto &lod : lods)
+	{
+		report << "  " << std::setw(6) << lod.mesh.indices.size() / 3 << " triangles"
+			<< std::setprecision(4) << "  ratio " << lod.ratio
+			<< std::setprecision(5) << "  error " << lod.error << "\n";
+	}
+
+	// Smooth subdivision, the box is welded first so its faces share corners
+	Mesh octahedron = Octahedron(1.0f);
+	Mesh loop;
+	double loopMs = TimeIt([&]() { loop = LoopSubdivide(octahedron, 8); }, 1);
+
+	Mesh box = Box(1.0f, 1.0f, 1.0f);
+	WeldVertices(box, 0.0f, WeldKey::Position);
+	Mesh catmullClark;
+	double catmullClarkMs = TimeIt([&]() { catmullClark = CatmullClarkSubdivide(box, 8); }, 1);
+
+	report << "Loop Octahedron 8 levels  " << loop.indices.size() / 3 << " triangles"
+		<< std::fixed << std::setprecision(2) << "  (" << loopMs << " ms)\n"
+		<< "Catmull-Clark Box 8 levels  " << catmullClark.indices.size() / 6 << " quads"
+		<< "  (" << catmullClarkMs << " ms)\n";
+
+	return report.str();
+}
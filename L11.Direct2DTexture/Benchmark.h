@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace Learnings
+{
+	// Time mesh generation and tangent frames at different thread counts, adaptive refinement
+	// terrain streaming and clipmap placement, returns a text report
+	std::string BenchmarkShapes();
+
+	// Vertex cache (ACMR/ATVR) and vertex fetch efficiency of generated meshes
+	// before and after optimization, weld, LOD and subdivision timing, returns a text report
+	std::string ReportMeshOptimization();
+}
@@ -0,0 +1,271 @@
+#include <cmath>
+#include <array>
+#include <utility>
+#include <stdexcept>
+
+#include "Clipmap.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+#pragma region Pieces
+// rows rows of cells by cells, laid out as a Grid triangle list is with its min corner moved to the origin.
+// Written directly rather than cut from a full Grid, so a one row trim costs one row
+static Mesh GridRows(uint32_t cells, uint32_t rows)
+{
+	uint64_t rowLength = cells + 1u;
+	uint64_t vertexCount = rowLength * (rows + 1u);
+	uint64_t indexCount = 6u * static_cast<uint64_t>(cells) * rows;
+	if (vertexCount >= C_StripCut || indexCount > UINT32_MAX)
+	{
+		throw std::length_error("Clipmap piece is too large for 32 bit indices");
+	}
+
+	Mesh piece;
+	MeshSpan out = piece.Resize({ static_cast<uint32_t>(vertexCount), static_cast<uint32_t>(indexCount) });
+
+	for (uint32_t j = 0; j <= rows; j++)
+	{
+		Vertex *vtx = out.vertices + j * rowLength;
+		for (uint32_t i = 0; i <= cells; i++)
+		{
+			vtx[i] = { { float(i), 0.0f, float(j) }, { float(i), float(j) } };
+		}
+	}
+
+	uint32_t *idx = out.indices;
+	for (uint32_t j = 0; j < rows; j++)
+	{
+		uint32_t lower = j * static_cast<uint32_t>(rowLength);
+		uint32_t upper = lower + static_cast<uint32_t>(rowLength);
+		for (uint32_t i = 0; i < cells; i++)
+		{
+			uint32_t v00 = lower + i, v01 = upper + i;
+			idx[0] = v00; idx[1] = v01; idx[2] = v00 + 1;
+			idx[3] = v00 + 1; idx[4] = v01; idx[5] = v01 + 1;
+			idx += 6;
+		}
+	}
+
+	return piece;
+}
+
+// Mirrored across x = z, with the winding reversed so it still faces +Y
+static Mesh Transposed(Mesh piece)
+{
+	for (auto &v : piece.vertices)
+	{
+		std::swap(v.position.x, v.position.z);
+		std::swap(v.texCoord.x, v.texCoord.y);
+	}
+
+	for (size_t i = 0; i < piece.indices.size(); i += 3)
+	{
+		std::swap(piece.indices[i + 1], piece.indices[i + 2]);
+	}
+
+	return piece;
+}
+
+// Every other vertex along a level's edge is a T-junction against the coarser level around it.
+// A zero area triangle over each pair of edges keeps them from opening into cracks when heights differ
+static Mesh Seam(uint32_t width)
+{
+	uint32_t ringLength = 4u * width;
+
+	Mesh seam;
+	seam.Resize({ ringLength, 3u * ringLength / 2u });
+
+	for (uint32_t k = 0; k < ringLength; k++)
+	{
+		uint32_t t = k % width;
+		float x, z;
+		switch (k / width)
+		{
+			case 0: x = float(t); z = 0.0f; break;
+			case 1: x = float(width); z = float(t); break;
+			case 2: x = float(width - t); z = float(width); break;
+			default: x = 0.0f; z = float(width - t); break;
+		}
+
+		seam.vertices[k] = { { x, 0.0f, z }, { x, z } };
+	}
+
+	uint32_t *idx = seam.indices.data();
+	for (uint32_t k = 0; k < ringLength; k += 2)
+	{
+		*idx++ = k;
+		*idx++ = k + 1;
+		*idx++ = (k + 2) % ringLength;
+	}
+
+	return seam;
+}
+
+Mesh Learnings::ClipmapPieceMesh(const ClipmapSettings &settings, ClipmapPiece piece)
+{
+	uint32_t b = settings.blockCells;
+	if (b < 2)
+	{
+		throw std::length_error("Clipmap blocks must be at least 2 cells");
+	}
+
+	Mesh mesh;
+	switch (piece)
+	{
+		case ClipmapPiece::Block:
+			mesh = GridRows(b, b);
+			break;
+		case ClipmapPiece::FixupX:
+			mesh = GridRows(b, 2);
+			break;
+		case ClipmapPiece::FixupZ:
+			mesh = Transposed(GridRows(b, 2));
+			break;
+		case ClipmapPiece::TrimX:
+			mesh = GridRows(2u * b + 2u, 1);
+			break;
+		case ClipmapPiece::TrimZ:
+			mesh = Transposed(GridRows(2u * b + 1u, 1));
+			break;
+		case ClipmapPiece::Centre:
+			mesh = GridRows(2, 2);
+			break;
+		case ClipmapPiece::Seam:
+			mesh = Seam(4u * b + 2u);
+			break;
+		default:
+			throw std::runtime_error("Unknown clipmap piece");
+	}
+
+	mesh.UpdateBounds();
+	return mesh;
+}
+
+uint32_t Learnings::ClipmapInstanceCount(const ClipmapSettings &settings, ClipmapPiece piece)
+{
+	if (settings.levelCount == 0)
+	{
+		return 0;
+	}
+
+	uint32_t rings = settings.levelCount - 1;
+
+	switch (piece)
+	{
+		case ClipmapPiece::Block:
+			return 16u + 12u * rings;
+		case ClipmapPiece::FixupX:
+		case ClipmapPiece::FixupZ:
+			return 4u + 2u * rings;
+		case ClipmapPiece::Centre:
+			return 1u;
+		case ClipmapPiece::TrimX:
+		case ClipmapPiece::TrimZ:
+		case ClipmapPiece::Seam:
+			return rings;
+		default:
+			return 0;
+	}
+}
+
+uint32_t Learnings::ClipmapInstanceCount(const ClipmapSettings &settings)
+{
+	uint32_t count = 0;
+	for (uint32_t p = 0; p < static_cast<uint32_t>(ClipmapPiece::Count); p++)
+	{
+		count += ClipmapInstanceCount(settings, static_cast<ClipmapPiece>(p));
+	}
+
+	return count;
+}
+#pragma endregion
+
+#pragma region Placement
+void Learnings::PlaceClipmap(const ClipmapSettings &settings, const Math::XMFLOAT3 &camera, std::vector<ClipmapInstance> &instances)
+{
+	instances.clear();
+	instances.reserve(ClipmapInstanceCount(settings));
+
+	const int64_t b = settings.blockCells;
+	const int64_t starts[4] = { 0, b, 2 * b + 2, 3 * b + 2 };	// block rows and columns, the fix-ups take 2b to 2b + 2
+
+	std::array<uint32_t, static_cast<size_t>(ClipmapPiece::Count)> placed = {};
+	int64_t finerX = 0, finerZ = 0;
+
+	for (uint32_t level = 0; level < settings.levelCount; level++)
+	{
+		double scale = std::ldexp(static_cast<double>(settings.cellSize), static_cast<int>(level));
+
+		// Min corner in this level's cells, even so it sits on the coarser level's vertices
+		int64_t originX = 2 * static_cast<int64_t>(std::floor(camera.x / (2.0 * scale))) - 2 * b;
+		int64_t originZ = 2 * static_cast<int64_t>(std::floor(camera.z / (2.0 * scale))) - 2 * b;
+
+		// Offsets in this level's cells from its min corner
+		auto place = [&](ClipmapPiece piece, int64_t x, int64_t z)
+		{
+			uint32_t &instance = placed[static_cast<size_t>(piece)];
+			instances.push_back({
+				piece, instance++, level,
+				{ static_cast<float>((originX + x) * scale), static_cast<float>((originZ + z) * scale) },
+				static_cast<float>(scale)
+			});
+		};
+
+		for (uint32_t bz = 0; bz < 4; bz++)
+		{
+			for (uint32_t bx = 0; bx < 4; bx++)
+			{
+				bool inner = (bx == 1 || bx == 2) && (bz == 1 || bz == 2);
+				if (level == 0 || !inner)
+				{
+					place(ClipmapPiece::Block, starts[bx], starts[bz]);
+				}
+			}
+		}
+
+		place(ClipmapPiece::FixupZ, 2 * b, 0);
+		place(ClipmapPiece::FixupZ, 2 * b, 3 * b + 2);
+		place(ClipmapPiece::FixupX, 0, 2 * b);
+		place(ClipmapPiece::FixupX, 3 * b + 2, 2 * b);
+
+		if (level == 0)
+		{
+			place(ClipmapPiece::FixupZ, 2 * b, b);
+			place(ClipmapPiece::FixupZ, 2 * b, 2 * b + 2);
+			place(ClipmapPiece::FixupX, b, 2 * b);
+			place(ClipmapPiece::FixupX, 2 * b + 2, 2 * b);
+			place(ClipmapPiece::Centre, 2 * b, 2 * b);
+		}
+		else
+		{
+			// The finer level is 2b + 1 of these cells across in a 2b + 2 hole, flush with one side
+			// of it on each axis. The trim takes the cell left over on the other side
+			bool lowX = (finerX - 2 * originX - 2 * b) != 0;
+			bool lowZ = (finerZ - 2 * originZ - 2 * b) != 0;
+
+			int64_t trimZ = lowZ ? b : 3 * b + 1;
+			place(ClipmapPiece::TrimX, b, trimZ);
+			place(ClipmapPiece::TrimZ, lowX ? b : 3 * b + 1, lowZ ? b + 1 : b);
+
+			// The finer level's outer edge, placed in its own cells
+			instances.push_back({
+				ClipmapPiece::Seam, placed[static_cast<size_t>(ClipmapPiece::Seam)]++, level - 1,
+				{ static_cast<float>(finerX * scale / 2.0), static_cast<float>(finerZ * scale / 2.0) },
+				static_cast<float>(scale / 2.0)
+			});
+		}
+
+		finerX = originX;
+		finerZ = originZ;
+	}
+}
+
+Transform Learnings::ClipmapTransform(const ClipmapInstance &instance)
+{
+	auto matrix = Math::XMMatrixScaling(instance.scale, 1.0f, instance.scale)
+		* Math::XMMatrixTranslation(instance.offset.x, 0.0f, instance.offset.y);
+
+	return{ Math::XMMatrixTranspose(matrix) };
+}
+#pragma endregion
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "Mesh.h"
+
+namespace Learnings
+{
+	// Reusable meshes a geometry clipmap is drawn from, in cells of size 1 with their
+	// min corner at the origin, in the XZ plane facing +Y. B is ClipmapSettings::blockCells
+	enum class ClipmapPiece : uint32_t
+	{
+		Block,		// B by B cells, twelve per ring, sixteen in the finest level
+		FixupX,		// B by 2, fills the gap in the middle of a ring along X
+		FixupZ,		// 2 by B, the same along Z
+		TrimX,		// 2B + 2 by 1, the row of the L shaped gap between a ring and the finer level inside it
+		TrimZ,		// 1 by 2B + 1, the column of that gap
+		Centre,		// 2 by 2, where the finest level's fix-ups cross
+		Seam,		// zero area triangles along a level's outer edge, closing its T-junctions with the next level
+		Count
+	};
+
+	// Level l has cells of cellSize * 2^l and is 4B + 2 cells across, the finest a full square,
+	// each coarser one a ring around the level inside it
+	struct ClipmapSettings
+	{
+		float cellSize;
+		uint16_t blockCells;	// at least 2, 63 gives the classic 255 vertex levels
+		uint32_t levelCount;
+	};
+
+	// One piece placed in the world, world = local * scale + offset in XZ.
+	// instance numbers the piece's placements 0 to ClipmapInstanceCount and stays the same from frame to frame
+	struct ClipmapInstance
+	{
+		ClipmapPiece piece;
+		uint32_t instance;
+		uint32_t level;
+		DirectX::XMFLOAT2 offset;
+		float scale;
+	};
+
+	// A piece's mesh, a Grid style triangle list built once and drawn through every instance. Texture coordinates
+	// are the local cell position, so a vertex shader can reach world position and a height map from the instance.
+	// The meshes are flat, heights are expected to come from that height map
+	Mesh ClipmapPieceMesh(const ClipmapSettings &settings, ClipmapPiece piece);
+
+	uint32_t ClipmapInstanceCount(const ClipmapSettings &settings, ClipmapPiece piece);
+	uint32_t ClipmapInstanceCount(const ClipmapSettings &settings);
+
+	// Levels around the camera, each snapped to twice its cell size so its vertices land on the
+	// coarser level's, which leaves the one cell trim to the side the camera is away from.
+	// instances is cleared and refilled, a fixed number per level with no allocation once it has grown,
+	// so the cost per frame is in levels and not in cells
+	void PlaceClipmap(const ClipmapSettings &settings, const DirectX::XMFLOAT3 &camera, std::vector<ClipmapInstance> &instances);
+
+	// Instance transform as Renderer::SetTransforms takes it, transposed
+	Transform ClipmapTransform(const ClipmapInstance &instance);
+}
@@ -154,8 +154,9 @@ Direct3d::Buffer Direct3d::CreateBuffer(uint32_t size, const void *data, D3D11_B
 	D3D11_SUBRESOURCE_DATA bData{ 0 };
 	bData.pSysMem = data;
 
+	// No data means buffer will be filled later (Map or CopyResource)
 	Buffer buf;
-	HRESULT hr = m_Device->CreateBuffer(&bd, &bData, &(buf.p));
+	HRESULT hr = m_Device->CreateBuffer(&bd, data ? &bData : NULL, &(buf.p));
 	ThrowIfFailed(hr, "Failed to create buffer");
 
 	return buf;
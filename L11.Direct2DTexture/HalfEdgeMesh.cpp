@@ -0,0 +1,464 @@
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "HalfEdgeMesh.h"
+
+#include "Parallel.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+#pragma region HalfEdgeMesh
+const uint32_t HalfEdgeMesh::C_None;
+
+// Read consecutive triangle pairs (a, b, c), (a, c, d) in any rotation as quads (a, b, c, d)
+static std::vector<uint32_t> PairTriangles(const std::vector<uint32_t> &indices)
+{
+	if (indices.size() % 6 != 0)
+	{
+		throw std::runtime_error("Index list does not hold whole quads");
+	}
+
+	std::vector<uint32_t> quads(indices.size() / 6 * 4);
+	for (size_t q = 0; q < quads.size() / 4; q++)
+	{
+		const uint32_t *t0 = &indices[q * 6];
+		const uint32_t *t1 = t0 + 3;
+
+		bool paired = false;
+		for (uint32_t r = 0; r < 3 && !paired; r++)
+		{
+			// Rotated so the shared edge runs from c back to a, the second triangle then has a to c
+			uint32_t a = t0[r], b = t0[(r + 1) % 3], c = t0[(r + 2) % 3];
+			for (uint32_t s = 0; s < 3 && !paired; s++)
+			{
+				if (t1[s] == a && t1[(s + 1) % 3] == c)
+				{
+					uint32_t *quad = &quads[q * 4];
+					quad[0] = a; quad[1] = b; quad[2] = c; quad[3] = t1[(s + 2) % 3];
+					paired = true;
+				}
+			}
+		}
+
+		if (!paired)
+		{
+			throw std::runtime_error("Consecutive triangles do not share an edge");
+		}
+	}
+
+	return quads;
+}
+
+HalfEdgeMesh::HalfEdgeMesh(const Mesh &mesh, uint32_t faceSize)
+	: m_FaceSize(faceSize), m_Vertices(mesh.vertices)
+{
+	assert(mesh.topology == D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST && "half-edge meshes are built from triangle lists");
+	assert((faceSize == 3 || faceSize == 4) && "only triangles or quads can be read from a Mesh");
+
+	m_Origin = (faceSize == 4) ? PairTriangles(mesh.indices) : mesh.indices;
+	Build();
+}
+
+HalfEdgeMesh::HalfEdgeMesh(std::vector<Vertex> vertices, std::vector<uint32_t> faceIndices, uint32_t faceSize)
+	: m_FaceSize(faceSize), m_Vertices(std::move(vertices)), m_Origin(std::move(faceIndices))
+{
+	Build();
+}
+
+void HalfEdgeMesh::Build()
+{
+	assert(m_FaceSize >= 3 && m_Origin.size() % m_FaceSize == 0 && "face index list is not whole faces");
+
+	uint32_t halfEdgeCount = HalfEdgeCount();
+	uint32_t vertexCount = VertexCount();
+
+	// Outgoing half-edges bucketed by origin, offsets then a counting sort
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (uint32_t h = 0; h < halfEdgeCount; h++)
+	{
+		assert(m_Origin[h] < vertexCount && "index out of range");
+		offsets[m_Origin[h] + 1]++;
+	}
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] += offsets[v];
+	}
+
+	std::vector<uint32_t> outgoing(halfEdgeCount);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (uint32_t h = 0; h < halfEdgeCount; h++)
+	{
+		outgoing[fill[m_Origin[h]]++] = h;
+	}
+
+	// Twin of a to b is an unpaired b to a, a third face on one edge stays a border
+	m_Twin.assign(halfEdgeCount, C_None);
+	for (uint32_t h = 0; h < halfEdgeCount; h++)
+	{
+		if (m_Twin[h] != C_None)
+		{
+			continue;
+		}
+
+		uint32_t a = Origin(h), b = Target(h);
+		for (uint32_t i = offsets[b]; i < offsets[b + 1]; i++)
+		{
+			uint32_t candidate = outgoing[i];
+			if (candidate != h && m_Twin[candidate] == C_None && Target(candidate) == a)
+			{
+				m_Twin[h] = candidate;
+				m_Twin[candidate] = h;
+				break;
+			}
+		}
+	}
+
+	// The lower half-edge of each pair numbers the edge, so the upper one finds it already set
+	m_Edge.resize(halfEdgeCount);
+	m_EdgeHalfEdge.clear();
+	for (uint32_t h = 0; h < halfEdgeCount; h++)
+	{
+		if (m_Twin[h] != C_None && m_Twin[h] < h)
+		{
+			m_Edge[h] = m_Edge[m_Twin[h]];
+		}
+		else
+		{
+			m_Edge[h] = static_cast<uint32_t>(m_EdgeHalfEdge.size());
+			m_EdgeHalfEdge.push_back(h);
+		}
+	}
+
+	// Starting on the border lets ForEachOutgoing reach the whole fan
+	m_VertexHalfEdge.assign(vertexCount, C_None);
+	for (uint32_t h = 0; h < halfEdgeCount; h++)
+	{
+		uint32_t &start = m_VertexHalfEdge[m_Origin[h]];
+		if (start == C_None || IsBorder(h))
+		{
+			start = h;
+		}
+	}
+}
+
+uint32_t HalfEdgeMesh::Valence(uint32_t v) const
+{
+	uint32_t valence = 0;
+	ForEachNeighbour(v, [&](uint32_t) { valence++; });
+
+	return valence;
+}
+
+Mesh HalfEdgeMesh::ToMesh() const
+{
+	uint32_t triangleCount = FaceCount() * (m_FaceSize - 2);
+
+	Mesh mesh;
+	MeshSpan out = mesh.Resize({ VertexCount(), triangleCount * 3 });
+
+	std::copy(m_Vertices.begin(), m_Vertices.end(), mesh.vertices.begin());
+
+	uint32_t *idx = out.indices;
+	for (uint32_t f = 0; f < FaceCount(); f++)
+	{
+		const uint32_t *face = &m_Origin[f * m_FaceSize];
+		for (uint32_t i = 1; i + 1 < m_FaceSize; i++)
+		{
+			*idx++ = face[0];
+			*idx++ = face[i];
+			*idx++ = face[i + 1];
+		}
+	}
+
+	mesh.UpdateBounds();
+	return mesh;
+}
+#pragma endregion
+
+#pragma region Subdivision
+// Position and texture coordinate sums, weights are applied by the caller
+struct VertexSum
+{
+	Math::XMVECTOR position = Math::XMVectorZero();
+	Math::XMVECTOR texCoord = Math::XMVectorZero();
+
+	void Add(const Vertex &v, float weight)
+	{
+		position = Math::XMVectorAdd(position, Math::XMVectorScale(Math::XMLoadFloat3(&v.position), weight));
+		texCoord = Math::XMVectorAdd(texCoord, Math::XMVectorScale(Math::XMLoadFloat2(&v.texCoord), weight));
+	}
+
+	Vertex Store() const
+	{
+		Vertex v;
+		Math::XMStoreFloat3(&v.position, position);
+		Math::XMStoreFloat2(&v.texCoord, texCoord);
+		return v;
+	}
+};
+
+static void CheckSubdividedSize(uint64_t vertexCount, uint64_t indexCount)
+{
+	if (vertexCount >= C_StripCut || indexCount > UINT32_MAX)
+	{
+		throw std::length_error("Subdivided mesh is too large for 32 bit indices");
+	}
+}
+
+// Cubic B-spline rule shared by both schemes, v and the two border neighbours
+static bool BorderVertex(const HalfEdgeMesh &mesh, uint32_t v, Vertex &out)
+{
+	if (!mesh.IsBorderVertex(v))
+	{
+		return false;
+	}
+
+	uint32_t start = mesh.VertexHalfEdge(v);
+	uint32_t last = start;
+	mesh.ForEachOutgoing(v, [&](uint32_t h) { last = h; });
+
+	const auto &vertices = mesh.Vertices();
+	Math::XMVECTOR position = Math::XMVectorScale(Math::XMLoadFloat3(&vertices[v].position), 0.75f);
+	position = Math::XMVectorAdd(position, Math::XMVectorScale(Math::XMLoadFloat3(&vertices[mesh.Target(start)].position), 0.125f));
+	position = Math::XMVectorAdd(position, Math::XMVectorScale(Math::XMLoadFloat3(&vertices[mesh.Origin(mesh.Prev(last))].position), 0.125f));
+
+	out = vertices[v];
+	Math::XMStoreFloat3(&out.position, position);
+	return true;
+}
+
+HalfEdgeMesh Learnings::LoopSubdivide(const HalfEdgeMesh &mesh, uint32_t threadCount)
+{
+	assert(mesh.FaceSize() == 3 && "Loop subdivision needs triangles");
+
+	uint32_t vertexCount = mesh.VertexCount();
+	uint32_t edgeCount = mesh.EdgeCount();
+	uint32_t faceCount = mesh.FaceCount();
+	CheckSubdividedSize(uint64_t(vertexCount) + edgeCount, uint64_t(faceCount) * 12u);
+
+	const auto &vertices = mesh.Vertices();
+	std::vector<Vertex> subdivided(vertexCount + edgeCount);
+
+	// Old vertices first, v' = (1 - k beta) v + beta * one ring
+	ParallelFor(vertexCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t v = begin; v < end; v++)
+		{
+			Vertex &out = subdivided[v];
+			if (mesh.VertexHalfEdge(v) == HalfEdgeMesh::C_None)
+			{
+				out = vertices[v];
+				continue;
+			}
+			if (BorderVertex(mesh, v, out))
+			{
+				continue;
+			}
+
+			uint32_t valence = mesh.Valence(v);
+			float beta = (valence == 3) ? 3.0f / 16.0f : 3.0f / (8.0f * valence);
+
+			VertexSum sum;
+			sum.Add(vertices[v], 1.0f - valence * beta);
+			mesh.ForEachNeighbour(v, [&](uint32_t n) { sum.Add(vertices[n], beta); });
+
+			out = sum.Store();
+			out.texCoord = vertices[v].texCoord;
+		}
+	});
+
+	// Then one per edge, 3/8 of each end and 1/8 of each opposite corner
+	ParallelFor(edgeCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t e = begin; e < end; e++)
+		{
+			uint32_t h = mesh.EdgeHalfEdge(e);
+			const Vertex &a = vertices[mesh.Origin(h)];
+			const Vertex &b = vertices[mesh.Target(h)];
+
+			VertexSum sum;
+			if (mesh.IsBorder(h))
+			{
+				sum.Add(a, 0.5f);
+				sum.Add(b, 0.5f);
+			}
+			else
+			{
+				sum.Add(a, 0.375f);
+				sum.Add(b, 0.375f);
+				sum.Add(vertices[mesh.Origin(mesh.Prev(h))], 0.125f);
+				sum.Add(vertices[mesh.Origin(mesh.Prev(mesh.Twin(h)))], 0.125f);
+			}
+
+			Vertex &out = subdivided[vertexCount + e];
+			out = sum.Store();
+			Math::XMStoreFloat2(&out.texCoord, Math::XMVectorScale(Math::XMVectorAdd(Math::XMLoadFloat2(&a.texCoord), Math::XMLoadFloat2(&b.texCoord)), 0.5f));
+		}
+	});
+
+	// Corner triangles keep the parent's winding, the middle one joins the three edge points
+	std::vector<uint32_t> faces(faceCount * 12u);
+	ParallelFor(faceCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t f = begin; f < end; f++)
+		{
+			uint32_t h = f * 3;
+			uint32_t a = mesh.Origin(h), b = mesh.Origin(h + 1), c = mesh.Origin(h + 2);
+			uint32_t ab = vertexCount + mesh.Edge(h);
+			uint32_t bc = vertexCount + mesh.Edge(h + 1);
+			uint32_t ca = vertexCount + mesh.Edge(h + 2);
+
+			uint32_t *idx = &faces[f * 12u];
+			idx[0] = a;  idx[1] = ab;  idx[2] = ca;
+			idx[3] = ab; idx[4] = b;   idx[5] = bc;
+			idx[6] = ca; idx[7] = bc;  idx[8] = c;
+			idx[9] = ab; idx[10] = bc; idx[11] = ca;
+		}
+	});
+
+	return HalfEdgeMesh(std::move(subdivided), std::move(faces), 3);
+}
+
+HalfEdgeMesh Learnings::CatmullClarkSubdivide(const HalfEdgeMesh &mesh, uint32_t threadCount)
+{
+	uint32_t faceSize = mesh.FaceSize();
+	uint32_t vertexCount = mesh.VertexCount();
+	uint32_t edgeCount = mesh.EdgeCount();
+	uint32_t faceCount = mesh.FaceCount();
+	CheckSubdividedSize(uint64_t(vertexCount) + edgeCount + faceCount, uint64_t(faceCount) * faceSize * 4u);
+
+	const auto &vertices = mesh.Vertices();
+	std::vector<Vertex> subdivided(vertexCount + edgeCount + faceCount);
+	uint32_t firstEdgePoint = vertexCount;
+	uint32_t firstFacePoint = vertexCount + edgeCount;
+
+	// Face points, the centroid of each face. Edge and vertex rules read them back
+	ParallelFor(faceCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t f = begin; f < end; f++)
+		{
+			VertexSum sum;
+			for (uint32_t i = 0; i < faceSize; i++)
+			{
+				sum.Add(vertices[mesh.Origin(f * faceSize + i)], 1.0f / faceSize);
+			}
+
+			subdivided[firstFacePoint + f] = sum.Store();
+		}
+	});
+
+	// Edge points, the average of both ends and both face points
+	ParallelFor(edgeCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t e = begin; e < end; e++)
+		{
+			uint32_t h = mesh.EdgeHalfEdge(e);
+			const Vertex &a = vertices[mesh.Origin(h)];
+			const Vertex &b = vertices[mesh.Target(h)];
+
+			VertexSum sum;
+			if (mesh.IsBorder(h))
+			{
+				sum.Add(a, 0.5f);
+				sum.Add(b, 0.5f);
+			}
+			else
+			{
+				sum.Add(a, 0.25f);
+				sum.Add(b, 0.25f);
+				sum.Add(subdivided[firstFacePoint + mesh.Face(h)], 0.25f);
+				sum.Add(subdivided[firstFacePoint + mesh.Face(mesh.Twin(h))], 0.25f);
+			}
+
+			Vertex &out = subdivided[firstEdgePoint + e];
+			out = sum.Store();
+			Math::XMStoreFloat2(&out.texCoord, Math::XMVectorScale(Math::XMVectorAdd(Math::XMLoadFloat2(&a.texCoord), Math::XMLoadFloat2(&b.texCoord)), 0.5f));
+		}
+	});
+
+	// Vertex points, (Q + 2R + (k - 3) v) / k over the k faces around v,
+	// Q averaging their face points and R the edge midpoints
+	ParallelFor(vertexCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t v = begin; v < end; v++)
+		{
+			Vertex &out = subdivided[v];
+			if (mesh.VertexHalfEdge(v) == HalfEdgeMesh::C_None)
+			{
+				out = vertices[v];
+				continue;
+			}
+			if (BorderVertex(mesh, v, out))
+			{
+				continue;
+			}
+
+			uint32_t valence = 0;
+			VertexSum faces, midpoints;
+			mesh.ForEachOutgoing(v, [&](uint32_t h)
+			{
+				faces.Add(subdivided[firstFacePoint + mesh.Face(h)], 1.0f);
+				midpoints.Add(vertices[mesh.Target(h)], 1.0f);
+				valence++;
+			});
+
+			// 2R = (k v + sum of neighbours) / k
+			float k = static_cast<float>(valence);
+			VertexSum sum;
+			sum.position = Math::XMVectorScale(faces.position, 1.0f / (k * k));
+			sum.position = Math::XMVectorAdd(sum.position, Math::XMVectorScale(midpoints.position, 1.0f / (k * k)));
+			sum.Add(vertices[v], (k - 2.0f) / k);
+
+			out = sum.Store();
+			out.texCoord = vertices[v].texCoord;
+		}
+	});
+
+	// Each corner becomes a quad of the corner, its two edge points and the face point
+	std::vector<uint32_t> quads(faceCount * faceSize * 4u);
+	ParallelFor(faceCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t f = begin; f < end; f++)
+		{
+			for (uint32_t i = 0; i < faceSize; i++)
+			{
+				uint32_t h = f * faceSize + i;
+				uint32_t *idx = &quads[h * 4u];
+
+				idx[0] = mesh.Origin(h);
+				idx[1] = firstEdgePoint + mesh.Edge(h);
+				idx[2] = firstFacePoint + f;
+				idx[3] = firstEdgePoint + mesh.Edge(mesh.Prev(h));
+			}
+		}
+	});
+
+	return HalfEdgeMesh(std::move(subdivided), std::move(quads), 4);
+}
+
+Mesh Learnings::LoopSubdivide(const Mesh &mesh, uint16_t levels, uint32_t threadCount)
+{
+	HalfEdgeMesh subdivided(mesh, 3);
+	for (uint16_t level = 0; level < levels; level++)
+	{
+		subdivided = LoopSubdivide(subdivided, threadCount);
+	}
+
+	return subdivided.ToMesh();
+}
+
+Mesh Learnings::CatmullClarkSubdivide(const Mesh &mesh, uint16_t levels, uint32_t faceSize, uint32_t threadCount)
+{
+	HalfEdgeMesh subdivided(mesh, faceSize);
+	for (uint16_t level = 0; level < levels; level++)
+	{
+		subdivided = CatmullClarkSubdivide(subdivided, threadCount);
+	}
+
+	return subdivided.ToMesh();
+}
+#pragma endregion
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+namespace Learnings
+{
+	// Index based half-edge adjacency for meshes whose faces all have the same number of corners.
+	// Half-edges of face f are the faceSize consecutive slots from f * faceSize, so next, prev
+	// and face are arithmetic and only origin, twin and edge are stored, in flat arrays.
+	// Adjacency follows vertex indices, so vertices split along UV seams make the seam a border.
+	// Weld by position first to treat the surface as closed
+	class HalfEdgeMesh
+	{
+	public:
+		static const uint32_t C_None = UINT32_MAX;
+
+		// faceSize 3 reads the index list as triangles. 4 pairs up consecutive triangles that share
+		// an edge into quads, the way Box, Rectangle and the Grid triangle list lay them out
+		explicit HalfEdgeMesh(const Mesh &mesh, uint32_t faceSize = 3);
+
+		// faceIndices holds faceSize vertex indices per face, front faces wound as in Mesh.
+		// Linear time, twins are found through a bucket of outgoing half-edges per vertex
+		HalfEdgeMesh(std::vector<Vertex> vertices, std::vector<uint32_t> faceIndices, uint32_t faceSize);
+
+		uint32_t FaceSize() const { return m_FaceSize; }
+		uint32_t FaceCount() const { return static_cast<uint32_t>(m_Origin.size()) / m_FaceSize; }
+		uint32_t HalfEdgeCount() const { return static_cast<uint32_t>(m_Origin.size()); }
+		uint32_t EdgeCount() const { return static_cast<uint32_t>(m_EdgeHalfEdge.size()); }
+		uint32_t VertexCount() const { return static_cast<uint32_t>(m_Vertices.size()); }
+
+		const std::vector<Vertex> &Vertices() const { return m_Vertices; }
+
+		uint32_t Next(uint32_t h) const { return (h % m_FaceSize == m_FaceSize - 1) ? h + 1 - m_FaceSize : h + 1; }
+		uint32_t Prev(uint32_t h) const { return (h % m_FaceSize == 0) ? h + m_FaceSize - 1 : h - 1; }
+		uint32_t Face(uint32_t h) const { return h / m_FaceSize; }
+		uint32_t Twin(uint32_t h) const { return m_Twin[h]; }
+		uint32_t Origin(uint32_t h) const { return m_Origin[h]; }
+		uint32_t Target(uint32_t h) const { return m_Origin[Next(h)]; }
+		bool IsBorder(uint32_t h) const { return m_Twin[h] == C_None; }
+
+		// Edges are numbered 0 to EdgeCount, a half-edge and its twin share one
+		uint32_t Edge(uint32_t h) const { return m_Edge[h]; }
+		uint32_t EdgeHalfEdge(uint32_t e) const { return m_EdgeHalfEdge[e]; }
+
+		// An outgoing half-edge, the border one when v is on a border, C_None when v is in no face
+		uint32_t VertexHalfEdge(uint32_t v) const { return m_VertexHalfEdge[v]; }
+		bool IsBorderVertex(uint32_t v) const { return m_VertexHalfEdge[v] != C_None && IsBorder(m_VertexHalfEdge[v]); }
+
+		// Outgoing half-edges of v, turning from VertexHalfEdge(v) until back at it or the next border.
+		// Only one fan of a non-manifold vertex is visited
+		template <typename Fn>
+		void ForEachOutgoing(uint32_t v, Fn fn) const
+		{
+			uint32_t start = m_VertexHalfEdge[v];
+			if (start == C_None)
+			{
+				return;
+			}
+
+			uint32_t h = start;
+			do
+			{
+				fn(h);
+				h = m_Twin[Prev(h)];
+			} while (h != C_None && h != start);
+		}
+
+		// One ring of v in order. On a border that also takes in the far end of the incoming border edge
+		template <typename Fn>
+		void ForEachNeighbour(uint32_t v, Fn fn) const
+		{
+			uint32_t last = C_None;
+			ForEachOutgoing(v, [&](uint32_t h)
+			{
+				fn(Target(h));
+				last = h;
+			});
+
+			if (last != C_None && IsBorder(Prev(last)))
+			{
+				fn(Origin(Prev(last)));
+			}
+		}
+
+		uint32_t Valence(uint32_t v) const;
+
+		// Faces split into triangle fans
+		Mesh ToMesh() const;
+
+	private:
+		void Build();
+
+		uint32_t m_FaceSize;
+		std::vector<Vertex> m_Vertices;
+
+		std::vector<uint32_t> m_Origin;			// per half-edge, the vertex it leaves
+		std::vector<uint32_t> m_Twin;			// per half-edge, C_None on borders
+		std::vector<uint32_t> m_Edge;			// per half-edge
+		std::vector<uint32_t> m_EdgeHalfEdge;	// per edge, its lower half-edge
+		std::vector<uint32_t> m_VertexHalfEdge;	// per vertex
+	};
+
+	// One round of Loop subdivision on a triangle mesh, four triangles per triangle.
+	// Borders follow the cubic B-spline rule, so both sides of a seam stay together
+	HalfEdgeMesh LoopSubdivide(const HalfEdgeMesh &mesh, uint32_t threadCount = 1);
+
+	// One round of Catmull-Clark subdivision, faceSize quads per face of any uniform size.
+	// Borders follow the cubic B-spline rule
+	HalfEdgeMesh CatmullClarkSubdivide(const HalfEdgeMesh &mesh, uint32_t threadCount = 1);
+
+	// levels rounds on a Mesh. Texture coordinates are interpolated linearly, only positions are smoothed
+	Mesh LoopSubdivide(const Mesh &mesh, uint16_t levels, uint32_t threadCount = 1);
+	Mesh CatmullClarkSubdivide(const Mesh &mesh, uint16_t levels, uint32_t faceSize = 4, uint32_t threadCount = 1);
+}
@@ -9,6 +9,8 @@
 #include "Renderer.h"
 #include "Mesh.h"
 #include "BasicShapes.h"
+#include "MeshCache.h"
+#include "Benchmark.h"
 
 std::vector<byte> ReadBinaryFile(const std::wstring &fileName)
 {
@@ -29,6 +31,16 @@ std::vector<byte> ReadBinaryFile(const std::wstring &fileName)
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow)
 {
 	UNREFERENCED_PARAMETER(hPrevInstance);
+
+	// Time mesh generation only, no window
+	if (std::wstring(pCmdLine).find(L"-benchmark") != std::wstring::npos)
+	{
+		auto report = Learnings::BenchmarkShapes() + Learnings::ReportMeshOptimization();
+		OutputDebugStringA(report.c_str());
+		std::ofstream(L"benchmark.txt") << report;
+		return 0;
+	}
+
 	CoInitializeEx(nullptr, COINITBASE_MULTITHREADED);
 
 	std::unique_ptr<Learnings::Window> wnd;
@@ -93,22 +105,27 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 	wnd = std::make_unique<Learnings::Window>(800, 500, L"L11. Direct2D Texture", Learnings::Window::Style::Windowed, callback);
 	rndr = std::make_unique<Learnings::Renderer>(wnd->m_hWnd);
 	
-	//auto shape = Learnings::Triangle(1.0f, 1.0f, 0.0f);
-	auto shape = Learnings::Rectangle(1.0f, 1.0f);
-	//auto shape = Learnings::Box(1.0f, 1.0f, 1.0f);
-	//auto shape = Learnings::Tetrahedron(1.0f);
-	//auto shape = Learnings::Octahedron(1.0f);
-	//auto shape = Learnings::Cylinder(0.5f, 0.5f, 1.0f, 10, true);
-	//auto shape = Learnings::Sphere(1.0f, 120, 120);
-	//auto shape = Learnings::Icosahedron(1.0f, 4);
-	//auto shape = Learnings::Dodecahedron(1.0f, 4);
+	// In memory only, -meshcache also keeps generated meshes on disk for later runs
+	bool diskCache = std::wstring(pCmdLine).find(L"-meshcache") != std::wstring::npos;
+	Learnings::MeshCache meshes(diskCache ? L"MeshCache" : L"");
+
+	//auto shape = meshes.Triangle(1.0f, 1.0f, 0.0f);
+	auto shape = meshes.Rectangle(1.0f, 1.0f);
+	//auto shape = meshes.Box(1.0f, 1.0f, 1.0f);
+	//auto shape = meshes.Tetrahedron(1.0f);
+	//auto shape = meshes.Octahedron(1.0f);
+	//auto shape = meshes.Cylinder(0.5f, 0.5f, 1.0f, 10, true);
+	//auto shape = meshes.Sphere(1.0f, 120, 120);
+	//auto shape = meshes.Icosahedron(1.0f, 4);
+	//auto shape = meshes.Dodecahedron(1.0f, 4);
 	uint32_t shapeIdx = 0;
-	rndr->AddGeometry(shapeIdx, shape);
+	rndr->AddGeometry(shapeIdx, *shape);
 
-	auto grid = Learnings::Grid(0.5f, 10);
 	uint32_t gridIdx = 1;
-	rndr->AddGeometry(gridIdx, grid);
-	rndr->SetTopology(gridIdx, D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	rndr->AddGeometry(gridIdx, Learnings::GridSize(10), [](const Learnings::MeshSpan &out)
+	{
+		Learnings::Grid(out, 0.5f, 10);
+	}, D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
 	
 	auto ms = DirectX::XMMatrixTranslation(0.0f, 0.0f, 0.0f);
 	Learnings::Transform transform{ DirectX::XMMatrixTranspose(ms) };
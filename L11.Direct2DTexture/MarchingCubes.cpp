@@ -0,0 +1,537 @@
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <unordered_map>
+#include <DirectXMath.h>
+
+#include "MarchingCubes.h"
+
+#include "Parallel.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+// Cells per block edge, a block samples (C_BlockCells + 1) cubed corners
+static const uint32_t C_BlockCells = 16;
+
+#pragma region Case Table
+// Corner c of a cube sits at (c & 1, (c >> 1) & 1, (c >> 2) & 1)
+// and edge e runs from corner C_EdgeCorner[e] along axis C_EdgeAxis[e]
+static const uint32_t C_MaxCaseTriangles = 12;
+
+struct CaseTable
+{
+	uint8_t edgeCorner[12];
+	uint8_t edgeAxis[12];
+	uint8_t triangleCount[256];
+	uint8_t edges[256][C_MaxCaseTriangles * 3];
+
+	// Built from the cube's topology instead of typed in. On every face the crossed edges are joined
+	// in pairs, the surface loops those make are wound to face the outside corners and fanned into triangles
+	CaseTable()
+	{
+		uint8_t edgeIndex[8][3];
+		uint32_t edgeCount = 0;
+		for (uint32_t c = 0; c < 8; c++)
+		{
+			for (uint32_t axis = 0; axis < 3; axis++)
+			{
+				if ((c & (1u << axis)) == 0)
+				{
+					edgeCorner[edgeCount] = static_cast<uint8_t>(c);
+					edgeAxis[edgeCount] = static_cast<uint8_t>(axis);
+					edgeIndex[c][axis] = static_cast<uint8_t>(edgeCount);
+					edgeIndex[c | (1u << axis)][axis] = static_cast<uint8_t>(edgeCount);
+					edgeCount++;
+				}
+			}
+		}
+
+		auto corner = [](uint32_t c) { return Math::XMVectorSet(float(c & 1), float((c >> 1) & 1), float((c >> 2) & 1), 0.0f); };
+		auto edgeBetween = [&](uint32_t c0, uint32_t c1)
+		{
+			uint32_t axis = (c0 ^ c1) == 1 ? 0 : (c0 ^ c1) == 2 ? 1 : 2;
+			return edgeIndex[c0][axis];
+		};
+
+		// Whether two edges lie on one face of the cube, all four of their corners agree on some axis
+		auto onOneFace = [&](uint32_t e0, uint32_t e1)
+		{
+			uint32_t corners[4] = { edgeCorner[e0], edgeCorner[e0] | (1u << edgeAxis[e0]), edgeCorner[e1], edgeCorner[e1] | (1u << edgeAxis[e1]) };
+			for (uint32_t axis = 0; axis < 3; axis++)
+			{
+				uint32_t bits = 0;
+				for (auto c : corners)
+				{
+					bits += (c >> axis) & 1;
+				}
+
+				if (bits == 0 || bits == 4)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		};
+
+		for (uint32_t inside = 0; inside < 256; inside++)
+		{
+			// Two links per crossed edge, one from each face it lies on
+			int8_t links[12][2];
+			memset(links, -1, sizeof(links));
+			auto link = [&](uint32_t e0, uint32_t e1)
+			{
+				links[e0][links[e0][0] < 0 ? 0 : 1] = static_cast<int8_t>(e1);
+				links[e1][links[e1][0] < 0 ? 0 : 1] = static_cast<int8_t>(e0);
+			};
+
+			for (uint32_t axis = 0; axis < 3; axis++)
+			{
+				for (uint32_t side = 0; side < 2; side++)
+				{
+					uint32_t u = 1u << ((axis + 1) % 3), v = 1u << ((axis + 2) % 3);
+					uint32_t base = side << axis;
+					uint32_t ring[4] = { base, base | u, base | u | v, base | v };
+
+					uint32_t crossed[4], crossedCount = 0;
+					for (uint32_t i = 0; i < 4; i++)
+					{
+						uint32_t c0 = ring[i], c1 = ring[(i + 1) % 4];
+						if (((inside >> c0) & 1) != ((inside >> c1) & 1))
+						{
+							crossed[crossedCount++] = edgeBetween(c0, c1);
+						}
+					}
+
+					if (crossedCount == 2)
+					{
+						link(crossed[0], crossed[1]);
+					}
+					else if (crossedCount == 4)
+					{
+						// Cut off each inside corner on its own
+						for (uint32_t i = 0; i < 4; i++)
+						{
+							if ((inside >> ring[i]) & 1)
+							{
+								link(edgeBetween(ring[(i + 3) % 4], ring[i]), edgeBetween(ring[i], ring[(i + 1) % 4]));
+							}
+						}
+					}
+				}
+			}
+
+			uint32_t count = 0;
+			bool visited[12] = {};
+			for (uint32_t start = 0; start < 12; start++)
+			{
+				if (links[start][0] < 0 || visited[start])
+				{
+					continue;
+				}
+
+				uint32_t loop[12], loopSize = 0;
+				int32_t previous = -1;
+				uint32_t current = start;
+				do
+				{
+					visited[current] = true;
+					loop[loopSize++] = current;
+
+					uint32_t next = (links[current][0] == previous) ? links[current][1] : links[current][0];
+					previous = static_cast<int32_t>(current);
+					current = next;
+				} while (current != start);
+
+				// Newell normal of the loop through the edge midpoints, against the inside to outside direction
+				Math::XMVECTOR normal = Math::XMVectorZero();
+				Math::XMVECTOR outward = Math::XMVectorZero();
+				for (uint32_t i = 0; i < loopSize; i++)
+				{
+					uint32_t e = loop[i], n = loop[(i + 1) % loopSize];
+					uint32_t c0 = edgeCorner[e], c1 = c0 | (1u << edgeAxis[e]);
+					uint32_t n0 = edgeCorner[n], n1 = n0 | (1u << edgeAxis[n]);
+
+					Math::XMVECTOR p = Math::XMVectorScale(Math::XMVectorAdd(corner(c0), corner(c1)), 0.5f);
+					Math::XMVECTOR q = Math::XMVectorScale(Math::XMVectorAdd(corner(n0), corner(n1)), 0.5f);
+					normal = Math::XMVectorAdd(normal, Math::XMVector3Cross(p, q));
+
+					Math::XMVECTOR along = Math::XMVectorSubtract(corner(c1), corner(c0));
+					outward = ((inside >> c0) & 1) ? Math::XMVectorAdd(outward, along) : Math::XMVectorSubtract(outward, along);
+				}
+
+				if (Math::XMVectorGetX(Math::XMVector3Dot(normal, outward)) < 0.0f)
+				{
+					std::reverse(loop, loop + loopSize);
+				}
+
+				// Clip ears whose closing chord cuts through the cube. A chord along a cube face would also be
+				// made by the neighbour on that face and leave four triangles on one edge
+				while (loopSize >= 3)
+				{
+					uint32_t ear = 0;
+					for (uint32_t i = 0; i < loopSize && loopSize > 3; i++)
+					{
+						if (!onOneFace(loop[(i + loopSize - 1) % loopSize], loop[(i + 1) % loopSize]))
+						{
+							ear = i;
+							break;
+						}
+					}
+
+					assert(count < C_MaxCaseTriangles && "marching cubes case has too many triangles");
+
+					uint8_t *triangle = &edges[inside][count * 3];
+					triangle[0] = static_cast<uint8_t>(loop[(ear + loopSize - 1) % loopSize]);
+					triangle[1] = static_cast<uint8_t>(loop[ear]);
+					triangle[2] = static_cast<uint8_t>(loop[(ear + 1) % loopSize]);
+					count++;
+
+					for (uint32_t i = ear + 1; i < loopSize; i++)
+					{
+						loop[i - 1] = loop[i];
+					}
+					loopSize--;
+				}
+			}
+
+			triangleCount[inside] = static_cast<uint8_t>(count);
+		}
+	}
+};
+
+static const CaseTable &Cases()
+{
+	static const CaseTable table;
+	return table;
+}
+#pragma endregion
+
+#pragma region Sparse Volume
+uint64_t SparseVolume::BrickKey(uint32_t bx, uint32_t by, uint32_t bz)
+{
+	// 21 bits a brick coordinate is well past any lattice that fits 32 bit indices
+	return (static_cast<uint64_t>(bz) << 42) | (static_cast<uint64_t>(by) << 21) | bx;
+}
+
+void SparseVolume::Set(uint32_t x, uint32_t y, uint32_t z, float value)
+{
+	auto &brick = m_Bricks[BrickKey(x / C_BrickSize, y / C_BrickSize, z / C_BrickSize)];
+	if (brick.empty())
+	{
+		brick.assign(C_BrickSize * C_BrickSize * C_BrickSize, m_Background);
+	}
+
+	brick[((z % C_BrickSize) * C_BrickSize + (y % C_BrickSize)) * C_BrickSize + (x % C_BrickSize)] = value;
+}
+
+float SparseVolume::Get(uint32_t x, uint32_t y, uint32_t z) const
+{
+	float value;
+	ReadRow(x, y, z, 1, &value);
+
+	return value;
+}
+
+void SparseVolume::ReadRow(uint32_t x, uint32_t y, uint32_t z, uint32_t count, float *values) const
+{
+	uint32_t end = x + count;
+	while (x < end)
+	{
+		uint32_t runEnd = std::min(end, (x / C_BrickSize + 1) * C_BrickSize);
+
+		auto found = m_Bricks.find(BrickKey(x / C_BrickSize, y / C_BrickSize, z / C_BrickSize));
+		if (found == m_Bricks.end())
+		{
+			for (uint32_t i = x; i < runEnd; i++)
+			{
+				*values++ = m_Background;
+			}
+		}
+		else
+		{
+			const float *row = &found->second[((z % C_BrickSize) * C_BrickSize + (y % C_BrickSize)) * C_BrickSize];
+			for (uint32_t i = x; i < runEnd; i++)
+			{
+				*values++ = row[i % C_BrickSize];
+			}
+		}
+
+		x = runEnd;
+	}
+}
+#pragma endregion
+
+#pragma region Polygonise
+// Writes count samples along x from lattice point (x, y, z)
+typedef std::function<void(uint32_t x, uint32_t y, uint32_t z, uint32_t count, float *values)> RowSampler;
+
+// One block's piece of the surface, indices are into its own vertices
+struct BlockSurface
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint64_t> edges;		// lattice edge each vertex lies on
+	std::vector<uint32_t> indices;
+};
+
+// Lattice edge from point (x, y, z) along axis, numbered the same by every block
+static uint64_t LatticeEdge(const VolumeGrid &grid, uint32_t x, uint32_t y, uint32_t z, uint32_t axis)
+{
+	uint64_t point = (static_cast<uint64_t>(z) * (grid.cellsY + 1u) + y) * (grid.cellsX + 1u) + x;
+	return point * 3u + axis;
+}
+
+// Whether a lattice edge lies on a face between blocks, where two blocks create its vertex
+static bool OnBlockFace(const VolumeGrid &grid, uint64_t edge)
+{
+	uint32_t axis = static_cast<uint32_t>(edge % 3u);
+	uint64_t point = edge / 3u;
+	uint32_t p[3];
+	p[0] = static_cast<uint32_t>(point % (grid.cellsX + 1u));
+	p[1] = static_cast<uint32_t>(point / (grid.cellsX + 1u) % (grid.cellsY + 1u));
+	p[2] = static_cast<uint32_t>(point / (grid.cellsX + 1u) / (grid.cellsY + 1u));
+
+	for (uint32_t a = 0; a < 3; a++)
+	{
+		if (a != axis && p[a] % C_BlockCells == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void PolygoniseBlock(const VolumeGrid &grid, const RowSampler &sampler, float isoValue,
+							uint32_t x0, uint32_t y0, uint32_t z0, BlockSurface &surface)
+{
+	const CaseTable &cases = Cases();
+
+	uint32_t nx = std::min(C_BlockCells, grid.cellsX - x0);
+	uint32_t ny = std::min(C_BlockCells, grid.cellsY - y0);
+	uint32_t nz = std::min(C_BlockCells, grid.cellsZ - z0);
+
+	// Corner samples, rows padded to whole vectors for the SIMD samplers
+	uint32_t pitch = (nx + 1u + 3u) & ~3u;
+	std::vector<float> values(pitch * (ny + 1u) * (nz + 1u));
+	for (uint32_t z = 0; z <= nz; z++)
+	{
+		for (uint32_t y = 0; y <= ny; y++)
+		{
+			sampler(x0, y0 + y, z0 + z, nx + 1u, &values[(z * (ny + 1u) + y) * pitch]);
+		}
+	}
+
+	auto value = [&](uint32_t x, uint32_t y, uint32_t z) { return values[(z * (ny + 1u) + y) * pitch + x]; };
+
+	// Nothing to do when the whole block is on one side
+	bool anyInside = false, anyOutside = false;
+	for (uint32_t z = 0; z <= nz; z++)
+	{
+		for (uint32_t y = 0; y <= ny; y++)
+		{
+			for (uint32_t x = 0; x <= nx; x++)
+			{
+				(value(x, y, z) < isoValue ? anyInside : anyOutside) = true;
+			}
+		}
+	}
+	if (!anyInside || !anyOutside)
+	{
+		return;
+	}
+
+	float extentX = grid.cellsX * grid.cellSize;
+	float extentZ = grid.cellsZ * grid.cellSize;
+	std::unordered_map<uint64_t, uint32_t> edgeVertices;
+
+	auto edgeVertex = [&](uint32_t x, uint32_t y, uint32_t z, uint32_t axis) -> uint32_t
+	{
+		uint64_t edge = LatticeEdge(grid, x0 + x, y0 + y, z0 + z, axis);
+		auto inserted = edgeVertices.insert({ edge, static_cast<uint32_t>(surface.vertices.size()) });
+		if (!inserted.second)
+		{
+			return inserted.first->second;
+		}
+
+		// Always from the lower corner, so both blocks on a face interpolate it the same way
+		uint32_t x1 = x + (axis == 0), y1 = y + (axis == 1), z1 = z + (axis == 2);
+		float v0 = value(x, y, z), v1 = value(x1, y1, z1);
+		float t = (v1 != v0) ? std::max(0.0f, std::min(1.0f, (isoValue - v0) / (v1 - v0))) : 0.5f;
+
+		float px = grid.origin.x + (x0 + x + (axis == 0 ? t : 0.0f)) * grid.cellSize;
+		float py = grid.origin.y + (y0 + y + (axis == 1 ? t : 0.0f)) * grid.cellSize;
+		float pz = grid.origin.z + (z0 + z + (axis == 2 ? t : 0.0f)) * grid.cellSize;
+
+		surface.vertices.push_back({
+			{ px, py, pz },
+			{ (px - grid.origin.x) / extentX, (pz - grid.origin.z) / extentZ }
+		});
+		surface.edges.push_back(edge);
+
+		return inserted.first->second;
+	};
+
+	for (uint32_t z = 0; z < nz; z++)
+	{
+		for (uint32_t y = 0; y < ny; y++)
+		{
+			for (uint32_t x = 0; x < nx; x++)
+			{
+				uint32_t inside = 0;
+				for (uint32_t c = 0; c < 8; c++)
+				{
+					if (value(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1)) < isoValue)
+					{
+						inside |= 1u << c;
+					}
+				}
+
+				const uint8_t *edges = cases.edges[inside];
+				for (uint32_t i = 0; i < cases.triangleCount[inside] * 3u; i++)
+				{
+					uint32_t c = cases.edgeCorner[edges[i]];
+					surface.indices.push_back(edgeVertex(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1), cases.edgeAxis[edges[i]]));
+				}
+			}
+		}
+	}
+}
+
+static Mesh Polygonise(const VolumeGrid &grid, const RowSampler &sampler, float isoValue, uint32_t threadCount)
+{
+	uint32_t blocksX = (grid.cellsX + C_BlockCells - 1) / C_BlockCells;
+	uint32_t blocksY = (grid.cellsY + C_BlockCells - 1) / C_BlockCells;
+	uint32_t blocksZ = (grid.cellsZ + C_BlockCells - 1) / C_BlockCells;
+	uint32_t blockCount = blocksX * blocksY * blocksZ;
+
+	// The field or a block's growth can throw, ParallelFor hands that to the caller.
+	// The other threads stop at their next block instead of finishing a surface that is thrown away
+	std::vector<BlockSurface> blocks(blockCount);
+	std::atomic<bool> failed(false);
+	ParallelFor(blockCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t b = begin; b < end && !failed.load(std::memory_order_relaxed); b++)
+		{
+			uint32_t bx = b % blocksX, by = b / blocksX % blocksY, bz = b / blocksX / blocksY;
+			try
+			{
+				PolygoniseBlock(grid, sampler, isoValue, bx * C_BlockCells, by * C_BlockCells, bz * C_BlockCells, blocks[b]);
+			}
+			catch (...)
+			{
+				failed = true;
+				throw;
+			}
+		}
+	});
+
+	// Number the vertices in block order, a vertex on a block face keeps the number the first block gave it
+	std::vector<std::vector<uint32_t>> remap(blockCount);
+	std::vector<std::vector<bool>> owned(blockCount);
+	std::vector<uint32_t> firstIndex(blockCount + 1, 0);
+	std::unordered_map<uint64_t, uint32_t> faceVertices;
+	uint64_t vertexCount = 0;
+
+	for (uint32_t b = 0; b < blockCount; b++)
+	{
+		auto &block = blocks[b];
+		remap[b].resize(block.vertices.size());
+		owned[b].resize(block.vertices.size(), true);
+
+		for (size_t v = 0; v < block.vertices.size(); v++)
+		{
+			if (OnBlockFace(grid, block.edges[v]))
+			{
+				auto inserted = faceVertices.insert({ block.edges[v], static_cast<uint32_t>(vertexCount) });
+				if (!inserted.second)
+				{
+					remap[b][v] = inserted.first->second;
+					owned[b][v] = false;
+					continue;
+				}
+			}
+
+			remap[b][v] = static_cast<uint32_t>(vertexCount++);
+		}
+
+		if (vertexCount >= C_StripCut || firstIndex[b] + block.indices.size() > UINT32_MAX)
+		{
+			throw std::length_error("Isosurface is too large for 32 bit indices");
+		}
+		firstIndex[b + 1] = firstIndex[b] + static_cast<uint32_t>(block.indices.size());
+	}
+
+	Mesh mesh;
+	mesh.Resize({ static_cast<uint32_t>(vertexCount), firstIndex[blockCount] });
+
+	ParallelFor(blockCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t b = begin; b < end; b++)
+		{
+			auto &block = blocks[b];
+			for (size_t v = 0; v < block.vertices.size(); v++)
+			{
+				if (owned[b][v])
+				{
+					mesh.vertices[remap[b][v]] = block.vertices[v];
+				}
+			}
+
+			uint32_t *idx = mesh.indices.data() + firstIndex[b];
+			for (auto i : block.indices)
+			{
+				*idx++ = remap[b][i];
+			}
+		}
+	});
+
+	mesh.UpdateBounds();
+	return mesh;
+}
+#pragma endregion
+
+#pragma region Sources
+Mesh Learnings::MarchingCubes(const VolumeGrid &grid, const VolumeFunction &field, float isoValue, uint32_t threadCount)
+{
+	const Math::XMVECTOR lanes = Math::XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+	const Math::XMVECTOR cellSize = Math::XMVectorReplicate(grid.cellSize);
+	const Math::XMVECTOR originX = Math::XMVectorReplicate(grid.origin.x);
+
+	// Four corners per call, values lands padded to a multiple of four
+	return Polygonise(grid, [&](uint32_t x, uint32_t y, uint32_t z, uint32_t count, float *values)
+	{
+		Math::XMVECTOR py = Math::XMVectorReplicate(grid.origin.y + y * grid.cellSize);
+		Math::XMVECTOR pz = Math::XMVectorReplicate(grid.origin.z + z * grid.cellSize);
+
+		for (uint32_t i = 0; i < count; i += 4)
+		{
+			Math::XMVECTOR lattice = Math::XMVectorAdd(Math::XMVectorReplicate(static_cast<float>(x + i)), lanes);
+			Math::XMVECTOR px = Math::XMVectorMultiplyAdd(lattice, cellSize, originX);
+
+			Math::XMStoreFloat4(reinterpret_cast<Math::XMFLOAT4 *>(values + i), field(px, py, pz));
+		}
+	}, isoValue, threadCount);
+}
+
+Mesh Learnings::MarchingCubes(const VolumeGrid &grid, const float *samples, float isoValue, uint32_t threadCount)
+{
+	return Polygonise(grid, [&](uint32_t x, uint32_t y, uint32_t z, uint32_t count, float *values)
+	{
+		size_t row = (static_cast<size_t>(z) * (grid.cellsY + 1u) + y) * (grid.cellsX + 1u);
+		memcpy(values, samples + row + x, count * sizeof(float));
+	}, isoValue, threadCount);
+}
+
+Mesh Learnings::MarchingCubes(const VolumeGrid &grid, const SparseVolume &samples, float isoValue, uint32_t threadCount)
+{
+	return Polygonise(grid, [&](uint32_t x, uint32_t y, uint32_t z, uint32_t count, float *values)
+	{
+		samples.ReadRow(x, y, z, count, values);
+	}, isoValue, threadCount);
+}
+#pragma endregion
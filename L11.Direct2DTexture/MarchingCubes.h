@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "Mesh.h"
+
+namespace Learnings
+{
+	// Lattice a volume is sampled on, cellsX * cellsY * cellsZ cubes of cellSize from origin.
+	// Samples sit on the (cellsX + 1) * (cellsY + 1) * (cellsZ + 1) cube corners
+	struct VolumeGrid
+	{
+		DirectX::XMFLOAT3 origin;
+		float cellSize;
+		uint32_t cellsX;
+		uint32_t cellsY;
+		uint32_t cellsZ;
+	};
+
+	// Field at four points at once, one per lane, so it can be written with XMVector math.
+	// Values below the iso value are inside
+	typedef std::function<DirectX::XMVECTOR(DirectX::FXMVECTOR x, DirectX::FXMVECTOR y, DirectX::FXMVECTOR z)> VolumeFunction;
+
+	// Samples stored in C_BrickSize cubed bricks, only allocated where written. The rest reads as background
+	class SparseVolume
+	{
+	public:
+		static const uint32_t C_BrickSize = 8;
+
+		explicit SparseVolume(float background) : m_Background(background) {}
+
+		void Set(uint32_t x, uint32_t y, uint32_t z, float value);
+		float Get(uint32_t x, uint32_t y, uint32_t z) const;
+
+		// count samples along x from (x, y, z), one brick lookup per brick crossed
+		void ReadRow(uint32_t x, uint32_t y, uint32_t z, uint32_t count, float *values) const;
+
+		size_t BrickCount() const { return m_Bricks.size(); }
+
+	private:
+		static uint64_t BrickKey(uint32_t bx, uint32_t by, uint32_t bz);
+
+		float m_Background;
+		std::unordered_map<uint64_t, std::vector<float>> m_Bricks;
+	};
+
+	// Marching cubes isosurface, wound so front faces look out of the volume, toward larger values.
+	// The lattice is cut into blocks that are sampled and polygonised on threadCount threads,
+	// each welding its vertices through its own edge map. Vertices on faces between blocks
+	// are then merged through one map of just those, so the whole surface is welded.
+	// Ambiguous cube faces keep inside corners apart, decided per face so neighbours agree and the surface is closed.
+	// Texture coordinates are x and z across the lattice, a top down planar map. Vertex has no normal,
+	// ComputeTangentFrames gives smooth ones.
+	// field is called from the threadCount threads, several at once. An exception it throws, or a failed
+	// allocation on any of them, is rethrown here once every thread has stopped
+	Mesh MarchingCubes(const VolumeGrid &grid, const VolumeFunction &field, float isoValue = 0.0f, uint32_t threadCount = 1);
+
+	// Dense samples, x fastest, then y, then z
+	Mesh MarchingCubes(const VolumeGrid &grid, const float *samples, float isoValue = 0.0f, uint32_t threadCount = 1);
+
+	// Sparse samples, lattice point (x, y, z) of grid reads volume.Get(x, y, z)
+	Mesh MarchingCubes(const VolumeGrid &grid, const SparseVolume &samples, float isoValue = 0.0f, uint32_t threadCount = 1);
+}
@@ -1,10 +1,151 @@
+#include <cmath>
+#include <cassert>
+
 #include "Mesh.h"
 
 using namespace Learnings;
+namespace Math = DirectX;
 
 const std::array<D3D11_INPUT_ELEMENT_DESC, Vertex::C_VertexElementCount> Learnings::Vertex::ElementsDesc{ {
 	{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 	{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 } };
 
-const uint32_t Vertex::Size = sizeof(Learnings::Vertex);
\ No newline at end of file
+const uint32_t Vertex::Size = sizeof(Learnings::Vertex);
+
+DXGI_FORMAT Learnings::IndexFormat(uint32_t vertexCount)
+{
+	return (vertexCount <= 0xFFFF) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+uint32_t Learnings::IndexSize(DXGI_FORMAT indexFormat)
+{
+	return (indexFormat == DXGI_FORMAT_R16_UINT) ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+uint32_t Learnings::PackIndices(uint32_t *indices, uint32_t indexCount, DXGI_FORMAT indexFormat)
+{
+	if (indexFormat == DXGI_FORMAT_R16_UINT)
+	{
+		uint16_t *packed = reinterpret_cast<uint16_t *>(indices);
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			// Truncation turns C_StripCut into the 16 bit cut
+			assert((indices[i] <= 0xFFFF || indices[i] == C_StripCut) && "index does not fit in 16 bits");
+			packed[i] = static_cast<uint16_t>(indices[i]);
+		}
+	}
+
+	return indexCount * IndexSize(indexFormat);
+}
+
+MeshSpan Mesh::Resize(const MeshSize &size)
+{
+	vertices.resize(size.vertexCount);
+	indices.resize(size.indexCount);
+	indexFormat = IndexFormat(size.vertexCount);
+
+	return{
+		vertices.data(), size.vertexCount,
+		indices.data(), size.indexCount
+	};
+}
+void Mesh::UpdateBounds()
+{
+	bounds = ComputeBounds(vertices.data(), static_cast<uint32_t>(vertices.size()));
+}
+
+// Position as x, y, z and whatever follows it in w, one unaligned load.
+// Only 3 component operations may look at the result
+static Math::XMVECTOR LoadPosition(const Vertex &vertex)
+{
+	static_assert(sizeof(Vertex) >= sizeof(Math::XMFLOAT4), "position load reads past the vertex");
+	return Math::XMLoadFloat4(reinterpret_cast<const Math::XMFLOAT4 *>(&vertex.position));
+}
+
+Bounds Learnings::ComputeBounds(const Vertex *vertices, uint32_t vertexCount)
+{
+	Bounds bounds = {};
+	if (vertexCount == 0)
+	{
+		return bounds;
+	}
+
+	// Box, remembering which vertex set each side
+	Math::XMVECTOR lo = LoadPosition(vertices[0]);
+	Math::XMVECTOR hi = lo;
+	Math::XMVECTOR loVertex = Math::XMVectorReplicateInt(0);
+	Math::XMVECTOR hiVertex = loVertex;
+
+	for (uint32_t i = 1; i < vertexCount; i++)
+	{
+		Math::XMVECTOR p = LoadPosition(vertices[i]);
+		Math::XMVECTOR vertex = Math::XMVectorReplicateInt(i);
+
+		Math::XMVECTOR below = Math::XMVectorLess(p, lo);
+		Math::XMVECTOR above = Math::XMVectorGreater(p, hi);
+
+		lo = Math::XMVectorSelect(lo, p, below);
+		hi = Math::XMVectorSelect(hi, p, above);
+		loVertex = Math::XMVectorSelect(loVertex, vertex, below);
+		hiVertex = Math::XMVectorSelect(hiVertex, vertex, above);
+	}
+
+	Math::XMStoreFloat3(&bounds.boxMin, lo);
+	Math::XMStoreFloat3(&bounds.boxMax, hi);
+
+	// Ritter: start from the most distant pair of axis extremes
+	uint32_t loIndex[3] = { Math::XMVectorGetIntX(loVertex), Math::XMVectorGetIntY(loVertex), Math::XMVectorGetIntZ(loVertex) };
+	uint32_t hiIndex[3] = { Math::XMVectorGetIntX(hiVertex), Math::XMVectorGetIntY(hiVertex), Math::XMVectorGetIntZ(hiVertex) };
+
+	uint32_t axis = 0;
+	float spanSq = -1.0f;
+	for (uint32_t a = 0; a < 3; a++)
+	{
+		Math::XMVECTOR span = Math::XMVectorSubtract(LoadPosition(vertices[hiIndex[a]]), LoadPosition(vertices[loIndex[a]]));
+		float lengthSq = Math::XMVectorGetX(Math::XMVector3LengthSq(span));
+		if (lengthSq > spanSq)
+		{
+			spanSq = lengthSq;
+			axis = a;
+		}
+	}
+
+	Math::XMVECTOR center = Math::XMVectorScale(Math::XMVectorAdd(LoadPosition(vertices[loIndex[axis]]), LoadPosition(vertices[hiIndex[axis]])), 0.5f);
+	float radius = 0.5f * std::sqrt(spanSq);
+	float radiusSq = radius * radius;
+
+	// Grow over the outliers, and measure the sphere around the box center in the same pass
+	Math::XMVECTOR boxCenter = Math::XMVectorScale(Math::XMVectorAdd(lo, hi), 0.5f);
+	Math::XMVECTOR boxRadiusSq = Math::XMVectorZero();
+
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		Math::XMVECTOR p = LoadPosition(vertices[i]);
+		boxRadiusSq = Math::XMVectorMax(boxRadiusSq, Math::XMVector3LengthSq(Math::XMVectorSubtract(p, boxCenter)));
+
+		Math::XMVECTOR offset = Math::XMVectorSubtract(p, center);
+		float distanceSq = Math::XMVectorGetX(Math::XMVector3LengthSq(offset));
+		if (distanceSq > radiusSq)
+		{
+			// New sphere touches p and the far side of the old one
+			float distance = std::sqrt(distanceSq);
+			float grown = 0.5f * (radius + distance);
+			center = Math::XMVectorAdd(center, Math::XMVectorScale(offset, (grown - radius) / distance));
+			radius = grown;
+			radiusSq = radius * radius;
+		}
+	}
+
+	float boxRadius = std::sqrt(Math::XMVectorGetX(boxRadiusSq));
+	if (boxRadius < radius)
+	{
+		center = boxCenter;
+		radius = boxRadius;
+	}
+
+	Math::XMStoreFloat3(&bounds.center, center);
+	bounds.radius = radius;
+
+	return bounds;
+}
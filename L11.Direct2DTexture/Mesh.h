@@ -18,6 +18,50 @@ namespace Learnings
 		static const uint32_t Size;
 	};
 
+	// Number of vertices and indices a generator will write
+	struct MeshSize
+	{
+		uint32_t vertexCount;
+		uint32_t indexCount;
+	};
+
+	// Output sink for generators, points at caller owned memory
+	// (a Mesh, an arena or a mapped upload buffer).
+	// Must hold at least the matching MeshSize
+	struct MeshSpan
+	{
+		Vertex *vertices;
+		uint32_t vertexCount;
+		uint32_t *indices;
+		uint32_t indexCount;
+	};
+
+	// Index that ends one strip and starts the next in strip topologies.
+	// Packs to 0xFFFF, the 16 bit cut value
+	const uint32_t C_StripCut = 0xFFFFFFFF;
+
+	// Narrowest index format that can address vertexCount vertices.
+	// 0xFFFF stays free as the strip cut value, so 16 bit holds up to 65535 vertices
+	DXGI_FORMAT IndexFormat(uint32_t vertexCount);
+	uint32_t IndexSize(DXGI_FORMAT indexFormat);
+
+	// Axis aligned box and bounding sphere around a mesh's positions
+	struct Bounds
+	{
+		DirectX::XMFLOAT3 boxMin;
+		DirectX::XMFLOAT3 boxMax;
+		DirectX::XMFLOAT3 center;
+		float radius;
+	};
+
+	// Box by a SIMD min/max reduction, sphere by Ritter's method seeded from the box's extreme vertices,
+	// or the sphere around the box center when that is tighter. Two passes over the vertices
+	Bounds ComputeBounds(const Vertex *vertices, uint32_t vertexCount);
+
+	// Narrow 32 bit indices in place to indexFormat, returns the size in bytes.
+	// Each narrowed index lands at or before the one it was read from, so front to back is safe
+	uint32_t PackIndices(uint32_t *indices, uint32_t indexCount, DXGI_FORMAT indexFormat);
+
 	struct Mesh
 	{
 		typedef std::vector<Vertex> VertexList;
@@ -25,6 +69,22 @@ namespace Learnings
 
 		VertexList vertices;
 		IndexList indices;
+
+		// Index width on the GPU, indices are always 32 bit while on the CPU.
+		// DXGI_FORMAT_UNKNOWN lets the upload pick from the vertex count
+		DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN;
+
+		// Optimization passes only run on triangle lists
+		D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+
+		// Set by generators, call UpdateBounds after moving vertices
+		Bounds bounds = {};
+
+		// Size lists to hold size and return them as a generator sink.
+		// Picks indexFormat for the new vertex count
+		MeshSpan Resize(const MeshSize &size);
+
+		void UpdateBounds();
 	};
 
 	struct Transform
@@ -0,0 +1,358 @@
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <Windows.h>
+
+#include "MeshCache.h"
+
+using namespace Learnings;
+
+#pragma region Key
+static uint32_t KeyBits(float value)
+{
+	// -0 and +0 generate the same mesh
+	value = value + 0.0f;
+
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static uint32_t KeyBits(uint32_t value)
+{
+	return value;
+}
+
+static uint32_t KeyBits(bool value)
+{
+	return value ? 1 : 0;
+}
+
+static uint32_t KeyBits(SubDivideMode value)
+{
+	return static_cast<uint32_t>(value);
+}
+
+static uint32_t KeyBits(PrimitiveMode value)
+{
+	return static_cast<uint32_t>(value);
+}
+
+// Bump a shape's version whenever its generator's output changes
+static uint32_t GeneratorVersion(MeshShape shape)
+{
+	switch (shape)
+	{
+		case MeshShape::Triangle:
+		case MeshShape::Rectangle:
+		case MeshShape::Box:
+		case MeshShape::Tetrahedron:
+		case MeshShape::Octahedron:
+		case MeshShape::Icosahedron:
+		case MeshShape::Dodecahedron:
+		case MeshShape::GeodesicSphere:
+		case MeshShape::Sphere:
+		case MeshShape::Cylinder:
+		case MeshShape::Grid:
+			return 1;
+		default:
+			throw std::runtime_error("Unknown mesh shape");
+	}
+}
+
+template <typename... Args>
+static MeshKey MakeKey(MeshShape shape, Args... args)
+{
+	static_assert(sizeof...(Args) <= MeshKey::C_MaxParameters, "Too many generator parameters for MeshKey");
+
+	MeshKey key{ shape, GeneratorVersion(shape), static_cast<uint32_t>(sizeof...(Args)), { { KeyBits(args)... } } };
+	return key;
+}
+
+bool MeshKey::operator==(const MeshKey &key) const
+{
+	return shape == key.shape
+		&& version == key.version
+		&& parameterCount == key.parameterCount
+		&& std::equal(parameters.begin(), parameters.begin() + parameterCount, key.parameters.begin());
+}
+
+size_t MeshKey::Hash() const
+{
+	// FNV-1a over the shape, version and parameters
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](uint32_t value)
+	{
+		hash = (hash ^ value) * 1099511628211ull;
+	};
+
+	mix(static_cast<uint32_t>(shape));
+	mix(version);
+	for (uint32_t i = 0; i < parameterCount; i++)
+	{
+		mix(parameters[i]);
+	}
+
+	return static_cast<size_t>(hash);
+}
+#pragma endregion
+
+#pragma region File
+// On-disk layout: header, vertices, 32 bit indices. Strip cuts are stored as 32 bit cuts
+struct MeshFileHeader
+{
+	static const uint32_t C_Magic = 0x48534D4C;	// "LMSH"
+	static const uint32_t C_Version = 3;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexSize;
+	MeshKey key;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	DXGI_FORMAT indexFormat;
+	D3D11_PRIMITIVE_TOPOLOGY topology;
+};
+#pragma endregion
+
+#pragma region MeshCache
+MeshCache::MeshCache(const std::wstring &directory)
+	: m_Directory(directory)
+{
+	if (!m_Directory.empty())
+	{
+		// Fails harmlessly when it already exists, a missing directory just disables the disk cache
+		CreateDirectoryW(m_Directory.c_str(), nullptr);
+	}
+}
+
+std::wstring MeshCache::FileName(const MeshKey &key) const
+{
+	std::wostringstream name;
+	name << m_Directory << L"\\"
+		<< std::hex << std::setfill(L'0') << std::setw(16) << static_cast<uint64_t>(key.Hash())
+		<< L".mesh";
+
+	return name.str();
+}
+
+MeshCache::MeshPtr MeshCache::Load(const MeshKey &key) const
+{
+	std::ifstream file(FileName(key), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return nullptr;
+	}
+
+	auto fileSize = static_cast<size_t>(file.tellg());
+	if (fileSize < sizeof(MeshFileHeader))
+	{
+		return nullptr;
+	}
+
+	MeshFileHeader header;
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+	// Stale format or a different key that hashed to the same name
+	if (header.magic != MeshFileHeader::C_Magic
+		|| header.version != MeshFileHeader::C_Version
+		|| header.vertexSize != sizeof(Vertex)
+		|| !(header.key == key))
+	{
+		return nullptr;
+	}
+
+	size_t vertexBytes = static_cast<size_t>(header.vertexCount) * sizeof(Vertex);
+	size_t indexBytes = static_cast<size_t>(header.indexCount) * sizeof(uint32_t);
+	if (fileSize != sizeof(header) + vertexBytes + indexBytes)
+	{
+		return nullptr;
+	}
+
+	auto mesh = std::make_shared<Mesh>();
+	mesh->vertices.resize(header.vertexCount);
+	mesh->indices.resize(header.indexCount);
+	mesh->indexFormat = header.indexFormat;
+	mesh->topology = header.topology;
+
+	// Read straight into the mesh, there is no intermediate buffer to copy out of
+	file.read(reinterpret_cast<char *>(mesh->vertices.data()), vertexBytes);
+	file.read(reinterpret_cast<char *>(mesh->indices.data()), indexBytes);
+	if (!file)
+	{
+		return nullptr;
+	}
+
+	mesh->UpdateBounds();
+
+	return mesh;
+}
+
+void MeshCache::Store(const MeshKey &key, const Mesh &mesh) const
+{
+	MeshFileHeader header{
+		MeshFileHeader::C_Magic,
+		MeshFileHeader::C_Version,
+		static_cast<uint32_t>(sizeof(Vertex)),
+		key,
+		static_cast<uint32_t>(mesh.vertices.size()),
+		static_cast<uint32_t>(mesh.indices.size()),
+		mesh.indexFormat,
+		mesh.topology
+	};
+
+	// A write cut short leaves a file of the wrong size, which Load rejects
+	std::ofstream file(FileName(key), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+	file.write(reinterpret_cast<const char *>(mesh.indices.data()), mesh.indices.size() * sizeof(uint32_t));
+}
+
+MeshCache::MeshPtr MeshCache::Get(const MeshKey &key, const std::function<Mesh()> &generate)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+
+		auto found = m_Meshes.find(key);
+		if (found != m_Meshes.end())
+		{
+			m_Hits++;
+			return found->second;
+		}
+	}
+
+	// Load or generate unlocked, so other shapes are not held up.
+	// Two threads racing for one key both build it and the first insert wins
+	bool loaded = false;
+	MeshPtr mesh;
+	if (!m_Directory.empty())
+	{
+		mesh = Load(key);
+		loaded = (mesh != nullptr);
+	}
+
+	if (!loaded)
+	{
+		mesh = std::make_shared<const Mesh>(generate());
+		if (!m_Directory.empty())
+		{
+			Store(key, *mesh);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	auto inserted = m_Meshes.emplace(key, mesh);
+	if (inserted.second)
+	{
+		(loaded ? m_Loads : m_Generated)++;
+	}
+
+	return inserted.first->second;
+}
+
+void MeshCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	m_Meshes.clear();
+}
+#pragma endregion
+
+#pragma region Shapes
+MeshCache::MeshPtr MeshCache::Triangle(float base, float height, float tipOffset)
+{
+	return Get(MakeKey(MeshShape::Triangle, base, height, tipOffset), [=]()
+	{
+		return Learnings::Triangle(base, height, tipOffset);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Rectangle(float length, float width)
+{
+	return Get(MakeKey(MeshShape::Rectangle, length, width), [=]()
+	{
+		return Learnings::Rectangle(length, width);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Box(float length, float width, float height)
+{
+	return Get(MakeKey(MeshShape::Box, length, width, height), [=]()
+	{
+		return Learnings::Box(length, width, height);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Tetrahedron(float radius)
+{
+	return Get(MakeKey(MeshShape::Tetrahedron, radius), [=]()
+	{
+		return Learnings::Tetrahedron(radius);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Octahedron(float radius)
+{
+	return Get(MakeKey(MeshShape::Octahedron, radius), [=]()
+	{
+		return Learnings::Octahedron(radius);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Icosahedron(float radius, uint16_t subdivide, SubDivideMode mode)
+{
+	return Get(MakeKey(MeshShape::Icosahedron, radius, uint32_t(subdivide), mode), [=]()
+	{
+		return Learnings::Icosahedron(radius, subdivide, mode);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Dodecahedron(float radius, uint16_t subdivide, SubDivideMode mode)
+{
+	return Get(MakeKey(MeshShape::Dodecahedron, radius, uint32_t(subdivide), mode), [=]()
+	{
+		return Learnings::Dodecahedron(radius, subdivide, mode);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::GeodesicSphere(float radius, uint16_t frequency)
+{
+	return Get(MakeKey(MeshShape::GeodesicSphere, radius, uint32_t(frequency)), [=]()
+	{
+		return Learnings::GeodesicSphere(radius, frequency);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Sphere(float radius, uint16_t slices, uint16_t stacks, uint32_t threadCount)
+{
+	return Get(MakeKey(MeshShape::Sphere, radius, uint32_t(slices), uint32_t(stacks)), [=]()
+	{
+		return Learnings::Sphere(radius, slices, stacks, threadCount);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Cylinder(float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap, PrimitiveMode mode)
+{
+	return Get(MakeKey(MeshShape::Cylinder, radiusTop, radiusBottom, height, uint32_t(slices), cap, mode), [=]()
+	{
+		return Learnings::Cylinder(radiusTop, radiusBottom, height, slices, cap, mode);
+	});
+}
+
+MeshCache::MeshPtr MeshCache::Grid(float cellSize, uint16_t cellCount, uint32_t threadCount, PrimitiveMode mode)
+{
+	return Get(MakeKey(MeshShape::Grid, cellSize, uint32_t(cellCount), mode), [=]()
+	{
+		return Learnings::Grid(cellSize, cellCount, threadCount, mode);
+	});
+}
+#pragma endregion
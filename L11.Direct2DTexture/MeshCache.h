@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "Mesh.h"
+#include "BasicShapes.h"
+
+namespace Learnings
+{
+	// Generator a cached mesh came from
+	enum class MeshShape : uint32_t
+	{
+		Triangle,
+		Rectangle,
+		Box,
+		Tetrahedron,
+		Octahedron,
+		Icosahedron,
+		Dodecahedron,
+		GeodesicSphere,
+		Sphere,
+		Cylinder,
+		Grid
+	};
+
+	// Generator, its version and its parameters, floats are keyed by their bits.
+	// The version is bumped with the generator's output, so files it wrote before are not served again
+	struct MeshKey
+	{
+		static const uint32_t C_MaxParameters = 6;
+
+		MeshShape shape;
+		uint32_t version;
+		uint32_t parameterCount;
+		std::array<uint32_t, C_MaxParameters> parameters;
+
+		bool operator==(const MeshKey &key) const;
+		size_t Hash() const;
+	};
+
+	struct MeshKeyHash
+	{
+		size_t operator()(const MeshKey &key) const { return key.Hash(); }
+	};
+
+	// Hands out one shared, immutable mesh per generator and parameters.
+	// With a directory, meshes are also written there as files and read back
+	// on the next run instead of being generated again.
+	// Thread count does not change a generator's output, so it is not part of the key
+	class MeshCache
+	{
+	public:
+		typedef std::shared_ptr<const Mesh> MeshPtr;
+
+		MeshCache() = default;
+		explicit MeshCache(const std::wstring &directory);
+
+		MeshPtr Triangle(float base, float height, float tipOffset);
+		MeshPtr Rectangle(float length, float width);
+		MeshPtr Box(float length, float width, float height);
+		MeshPtr Tetrahedron(float radius);
+		MeshPtr Octahedron(float radius);
+		MeshPtr Icosahedron(float radius, uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+		MeshPtr Dodecahedron(float radius, uint16_t subdivide, SubDivideMode mode = SubDivideMode::Shared);
+		MeshPtr GeodesicSphere(float radius, uint16_t frequency);
+		MeshPtr Sphere(float radius, uint16_t slices, uint16_t stacks, uint32_t threadCount = 1);
+		MeshPtr Cylinder(float radiusTop, float radiusBottom, float height, uint16_t slices, bool cap, PrimitiveMode mode = PrimitiveMode::TriangleList);
+		MeshPtr Grid(float cellSize, uint16_t cellCount, uint32_t threadCount = 1, PrimitiveMode mode = PrimitiveMode::LineList);
+
+		// Cached mesh for key, from memory, then disk, then generate
+		MeshPtr Get(const MeshKey &key, const std::function<Mesh()> &generate);
+
+		// Drop the in-memory meshes, files on disk are kept
+		void Clear();
+
+		uint32_t HitCount() const { return m_Hits; }
+		uint32_t LoadCount() const { return m_Loads; }
+		uint32_t GenerateCount() const { return m_Generated; }
+
+	private:
+		std::wstring FileName(const MeshKey &key) const;
+		MeshPtr Load(const MeshKey &key) const;
+		void Store(const MeshKey &key, const Mesh &mesh) const;
+
+		std::wstring m_Directory;
+
+		std::mutex m_Lock;
+		std::unordered_map<MeshKey, MeshPtr, MeshKeyHash> m_Meshes;
+
+		uint32_t m_Hits = 0;
+		uint32_t m_Loads = 0;
+		uint32_t m_Generated = 0;
+	};
+}
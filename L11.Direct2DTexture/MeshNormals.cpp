@@ -0,0 +1,207 @@
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "MeshNormals.h"
+
+#include "Mesh.h"
+#include "Parallel.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+#pragma region Accumulation
+// One thread's running sums, over the vertices its triangles touch
+struct VertexSums
+{
+	uint32_t first = 0;
+	uint32_t last = 0;		// one past the highest vertex
+	std::vector<Math::XMFLOAT4> sums;
+};
+
+// Split the triangles into one range per thread. face(triangle, corners) fills in what each of a
+// triangle's three corners adds to its vertex, summed into the range's own VertexSums.
+// Vertex ranges then add up every range's sums and pass the total to finish(vertex, sum).
+// Generated and cache optimized meshes touch a narrow band of vertices per triangle range,
+// so the per-thread buffers stay far smaller than thread count times the vertex count
+template <typename FaceFn, typename FinishFn>
+static void AccumulateFaces(const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t threadCount, FaceFn face, FinishFn finish)
+{
+	uint32_t triangleCount = indexCount / 3;
+	uint32_t rangeCount = std::min(ThreadCount(threadCount), std::max(triangleCount, 1u));
+
+	std::vector<VertexSums> ranges(rangeCount);
+
+	// As many ranges as threads, so every thread owns one VertexSums
+	ParallelFor(rangeCount, rangeCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t r = begin; r < end; r++)
+		{
+			const uint32_t *first = indices + 3 * (static_cast<uint64_t>(triangleCount) * r / rangeCount);
+			const uint32_t *last = indices + 3 * (static_cast<uint64_t>(triangleCount) * (r + 1) / rangeCount);
+			if (first == last)
+			{
+				continue;
+			}
+
+			auto &range = ranges[r];
+			auto extent = std::minmax_element(first, last);
+			range.first = *extent.first;
+			range.last = *extent.second + 1;
+			range.sums.assign(range.last - range.first, Math::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f));
+
+			for (const uint32_t *tri = first; tri != last; tri += 3)
+			{
+				Math::XMVECTOR corners[3];
+				face(tri, corners);
+
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					auto &sum = range.sums[tri[k] - range.first];
+					Math::XMStoreFloat4(&sum, Math::XMVectorAdd(Math::XMLoadFloat4(&sum), corners[k]));
+				}
+			}
+		}
+	});
+
+	// Ranges are added in order, so the total only depends on the thread count
+	ParallelFor(vertexCount, threadCount, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t v = begin; v < end; v++)
+		{
+			Math::XMVECTOR sum = Math::XMVectorZero();
+			for (auto &range : ranges)
+			{
+				if (v >= range.first && v < range.last)
+				{
+					sum = Math::XMVectorAdd(sum, Math::XMLoadFloat4(&range.sums[v - range.first]));
+				}
+			}
+
+			finish(v, sum);
+		}
+	});
+}
+#pragma endregion
+
+#pragma region Frames
+// v with its component along unit n removed
+static Math::XMVECTOR RejectFrom(Math::FXMVECTOR v, Math::FXMVECTOR n)
+{
+	return Math::XMVectorSubtract(v, Math::XMVectorScale(n, Math::XMVectorGetX(Math::XMVector3Dot(n, v))));
+}
+
+// Unit vector, or zero when v is too short to have a direction
+static Math::XMVECTOR SafeNormalize(Math::FXMVECTOR v)
+{
+	float length = Math::XMVectorGetX(Math::XMVector3Length(v));
+	return (length > 1e-20f) ? Math::XMVectorScale(v, 1.0f / length) : Math::XMVectorZero();
+}
+
+// Any unit vector perpendicular to unit n, for vertices whose faces give no tangent
+static Math::XMVECTOR Perpendicular(Math::FXMVECTOR n)
+{
+	// Cross with the axis n is least aligned with
+	Math::XMFLOAT3 a;
+	Math::XMStoreFloat3(&a, n);
+	Math::XMVECTOR axis = (std::fabs(a.x) < 0.9f) ? Math::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : Math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+	Math::XMVECTOR t = SafeNormalize(Math::XMVector3Cross(n, axis));
+	return Math::XMVector3Equal(t, Math::XMVectorZero()) ? axis : t;
+}
+
+static void ComputeFrames(const Vertex *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount, TangentFrame *frames, uint32_t threadCount)
+{
+	assert(indexCount % 3 == 0 && "tangent frames need a triangle list");
+
+	auto position = [&](uint32_t v) { return Math::XMLoadFloat3(&vertices[v].position); };
+	auto normal = [&](uint32_t v) { return Math::XMLoadFloat3(&frames[v].normal); };
+
+	// Normals, the unnormalised face normal is twice the triangle's area
+	AccumulateFaces(indices, indexCount, vertexCount, threadCount,
+					[&](const uint32_t *tri, Math::XMVECTOR *corners)
+	{
+		Math::XMVECTOR p0 = position(tri[0]);
+		Math::XMVECTOR faceNormal = Math::XMVector3Cross(Math::XMVectorSubtract(position(tri[1]), p0),
+														 Math::XMVectorSubtract(position(tri[2]), p0));
+		corners[0] = corners[1] = corners[2] = faceNormal;
+	},
+					[&](uint32_t v, Math::FXMVECTOR sum)
+	{
+		Math::XMStoreFloat3(&frames[v].normal, SafeNormalize(sum));
+	});
+
+	// Tangents, xyz sums the projected face tangents and w the signed corner angles
+	AccumulateFaces(indices, indexCount, vertexCount, threadCount,
+					[&](const uint32_t *tri, Math::XMVECTOR *corners)
+	{
+		const Vertex &v0 = vertices[tri[0]], &v1 = vertices[tri[1]], &v2 = vertices[tri[2]];
+
+		float du1 = v1.texCoord.x - v0.texCoord.x, dv1 = v1.texCoord.y - v0.texCoord.y;
+		float du2 = v2.texCoord.x - v0.texCoord.x, dv2 = v2.texCoord.y - v0.texCoord.y;
+		float det = du1 * dv2 - du2 * dv1;
+
+		if (std::fabs(det) < 1e-20f)
+		{
+			corners[0] = corners[1] = corners[2] = Math::XMVectorZero();
+			return;
+		}
+
+		Math::XMVECTOR p[3] = { position(tri[0]), position(tri[1]), position(tri[2]) };
+		Math::XMVECTOR e1 = Math::XMVectorSubtract(p[1], p[0]);
+		Math::XMVECTOR e2 = Math::XMVectorSubtract(p[2], p[0]);
+
+		// Directions of increasing u and v across the face
+		Math::XMVECTOR dPdu = Math::XMVectorScale(Math::XMVectorSubtract(Math::XMVectorScale(e1, dv2), Math::XMVectorScale(e2, dv1)), 1.0f / det);
+		Math::XMVECTOR dPdv = Math::XMVectorScale(Math::XMVectorSubtract(Math::XMVectorScale(e2, du1), Math::XMVectorScale(e1, du2)), 1.0f / det);
+
+		Math::XMVECTOR faceNormal = Math::XMVector3Cross(e1, e2);
+		float sign = (Math::XMVectorGetX(Math::XMVector3Dot(Math::XMVector3Cross(faceNormal, dPdu), dPdv)) < 0.0f) ? -1.0f : 1.0f;
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			Math::XMVECTOR n = normal(tri[k]);
+			Math::XMVECTOR tangent = SafeNormalize(RejectFrom(dPdu, n));
+
+			// Corner angle measured in the vertex's tangent plane
+			Math::XMVECTOR a = SafeNormalize(RejectFrom(Math::XMVectorSubtract(p[(k + 1) % 3], p[k]), n));
+			Math::XMVECTOR b = SafeNormalize(RejectFrom(Math::XMVectorSubtract(p[(k + 2) % 3], p[k]), n));
+			float cosAngle = std::max(-1.0f, std::min(1.0f, Math::XMVectorGetX(Math::XMVector3Dot(a, b))));
+			float angle = std::acos(cosAngle);
+
+			corners[k] = Math::XMVectorSetW(Math::XMVectorScale(tangent, angle), sign * angle);
+		}
+	},
+					[&](uint32_t v, Math::FXMVECTOR sum)
+	{
+		Math::XMVECTOR n = normal(v);
+		Math::XMVECTOR tangent = SafeNormalize(RejectFrom(sum, n));
+		if (Math::XMVector3Equal(tangent, Math::XMVectorZero()))
+		{
+			tangent = Perpendicular(n);
+		}
+
+		float sign = (Math::XMVectorGetW(sum) < 0.0f) ? -1.0f : 1.0f;
+		Math::XMStoreFloat4(&frames[v].tangent, Math::XMVectorSetW(tangent, sign));
+	});
+}
+
+void Learnings::ComputeTangentFrames(const MeshSpan &mesh, TangentFrame *frames, uint32_t threadCount)
+{
+	ComputeFrames(mesh.vertices, mesh.vertexCount, mesh.indices, mesh.indexCount, frames, threadCount);
+}
+
+std::vector<TangentFrame> Learnings::ComputeTangentFrames(const Mesh &mesh, uint32_t threadCount)
+{
+	assert(mesh.topology == D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST && "tangent frames need a triangle list");
+
+	std::vector<TangentFrame> frames(mesh.vertices.size());
+	ComputeFrames(mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()),
+				  mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()),
+				  frames.data(), threadCount);
+
+	return frames;
+}
+#pragma endregion
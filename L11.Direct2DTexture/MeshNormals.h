@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+namespace Learnings
+{
+	struct Mesh;
+	struct MeshSpan;
+
+	// Lighting frame of one vertex, kept beside the vertices since Vertex has no room for it
+	struct TangentFrame
+	{
+		DirectX::XMFLOAT3 normal;
+		DirectX::XMFLOAT4 tangent;	// w is the bitangent sign, bitangent = w * cross(normal, tangent)
+	};
+
+	// Area weighted vertex normals, then tangents the MikkTSpace way: per face UV tangents projected
+	// into each vertex's normal plane, weighted by the corner angle, sign from the face bitangents.
+	// Vertices are not split, so a UV seam keeps a crease and mirrored faces sharing a vertex
+	// take the majority sign. Faces with no UV area add no tangent, and unreferenced vertices get a zero normal.
+	// Triangle ranges run on threadCount threads (0 is one per hardware thread), each summing into
+	// its own buffer over just the vertices it touches, then vertex ranges reduce them in parallel.
+	// Results differ between thread counts only by float rounding
+	void ComputeTangentFrames(const MeshSpan &mesh, TangentFrame *frames, uint32_t threadCount = 1);
+	std::vector<TangentFrame> ComputeTangentFrames(const Mesh &mesh, uint32_t threadCount = 1);
+}
@@ -0,0 +1,545 @@
+#include <cmath>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "MeshOptimizer.h"
+
+#include "Mesh.h"
+
+using namespace Learnings;
+
+#pragma region Analysis
+VertexCacheStats Learnings::AnalyzeVertexCache(const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats{ 0, indexCount / 3, 0, 0.0f, 0.0f };
+
+	// FIFO cache: a vertex is still cached while fewer than cacheSize
+	// transforms have happened since it was loaded. 0 means never loaded
+	std::vector<uint32_t> loadedAt(vertexCount, 0);
+
+	for (uint32_t i = 0; i < stats.triangleCount * 3; i++)
+	{
+		uint32_t v = indices[i];
+		assert(v < vertexCount && "index out of range");
+
+		if (loadedAt[v] == 0)
+		{
+			stats.vertexCount++;
+		}
+
+		if (loadedAt[v] == 0 || stats.transformCount - loadedAt[v] >= cacheSize)
+		{
+			stats.transformCount++;
+			loadedAt[v] = stats.transformCount;
+		}
+	}
+
+	if (stats.triangleCount > 0)
+	{
+		stats.acmr = static_cast<float>(stats.transformCount) / stats.triangleCount;
+	}
+	if (stats.vertexCount > 0)
+	{
+		stats.atvr = static_cast<float>(stats.transformCount) / stats.vertexCount;
+	}
+
+	return stats;
+}
+
+VertexFetchStats Learnings::AnalyzeVertexFetch(const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t vertexSize)
+{
+	VertexFetchStats stats{ 0, 0.0f };
+
+	uint32_t vertexBytes = vertexCount * vertexSize;
+	uint32_t lineCount = (vertexBytes + C_FetchLineSize - 1) / C_FetchLineSize;
+
+	// Same FIFO timestamp trick as AnalyzeVertexCache, once for vertices and once for lines
+	std::vector<uint32_t> loadedAt(vertexCount, 0);
+	std::vector<uint32_t> lineLoadedAt(lineCount, 0);
+	std::vector<bool> referenced(vertexCount, false);
+	uint32_t transformCount = 0, lineLoads = 0;
+
+	for (uint32_t i = 0; i < indexCount - indexCount % 3; i++)
+	{
+		uint32_t v = indices[i];
+		assert(v < vertexCount && "index out of range");
+		referenced[v] = true;
+
+		if (loadedAt[v] != 0 && transformCount - loadedAt[v] < C_VertexCacheSize)
+		{
+			continue;
+		}
+		loadedAt[v] = ++transformCount;
+
+		uint32_t firstLine = v * vertexSize / C_FetchLineSize;
+		uint32_t lastLine = ((v + 1) * vertexSize - 1) / C_FetchLineSize;
+
+		for (uint32_t line = firstLine; line <= lastLine; line++)
+		{
+			if (lineLoadedAt[line] == 0 || lineLoads - lineLoadedAt[line] >= C_FetchCacheLines)
+			{
+				lineLoadedAt[line] = ++lineLoads;
+			}
+		}
+	}
+
+	stats.bytesFetched = lineLoads * C_FetchLineSize;
+
+	uint32_t referencedCount = static_cast<uint32_t>(std::count(referenced.begin(), referenced.end(), true));
+	if (referencedCount > 0)
+	{
+		stats.overfetch = static_cast<float>(stats.bytesFetched) / (referencedCount * vertexSize);
+	}
+
+	return stats;
+}
+
+VertexFetchStats Learnings::AnalyzeVertexFetch(const Mesh &mesh)
+{
+	return AnalyzeVertexFetch(mesh.indices.data(),
+							  static_cast<uint32_t>(mesh.indices.size()),
+							  static_cast<uint32_t>(mesh.vertices.size()),
+							  Vertex::Size);
+}
+
+VertexCacheStats Learnings::AnalyzeVertexCache(const Mesh &mesh, uint32_t cacheSize)
+{
+	return AnalyzeVertexCache(mesh.indices.data(),
+							  static_cast<uint32_t>(mesh.indices.size()),
+							  static_cast<uint32_t>(mesh.vertices.size()),
+							  cacheSize);
+}
+#pragma endregion
+
+#pragma region Forsyth
+// Scoring cache is larger than the real one, it only ranks vertices.
+// https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+static const uint32_t C_ScoreCacheSize = 32;
+static const uint32_t C_ValenceTableSize = 32;
+
+struct ScoreTables
+{
+	float cache[C_ScoreCacheSize];
+	float valence[C_ValenceTableSize];
+
+	ScoreTables()
+	{
+		const float cacheDecayPower = 1.5f;
+		const float lastTriScore = 0.75f;
+
+		for (uint32_t i = 0; i < C_ScoreCacheSize; i++)
+		{
+			// The three vertices of the last triangle score the same,
+			// so there is no bias towards one winding
+			if (i < 3)
+			{
+				cache[i] = lastTriScore;
+			}
+			else
+			{
+				float scaler = 1.0f - (i - 3) / static_cast<float>(C_ScoreCacheSize - 3);
+				cache[i] = std::pow(scaler, cacheDecayPower);
+			}
+		}
+
+		valence[0] = 0.0f;
+		for (uint32_t i = 1; i < C_ValenceTableSize; i++)
+		{
+			valence[i] = ValenceScore(i);
+		}
+	}
+
+	// Boost vertices with few triangles left, so lone triangles get finished off
+	static float ValenceScore(uint32_t remaining)
+	{
+		const float valenceBoostScale = 2.0f;
+		const float valenceBoostPower = 0.5f;
+
+		return valenceBoostScale * std::pow(static_cast<float>(remaining), -valenceBoostPower);
+	}
+
+	float Score(int32_t cachePosition, uint32_t remaining) const
+	{
+		if (remaining == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = (cachePosition >= 0) ? cache[cachePosition] : 0.0f;
+		score += (remaining < C_ValenceTableSize) ? valence[remaining] : ValenceScore(remaining);
+
+		return score;
+	}
+};
+
+void Learnings::OptimizeVertexCache(uint32_t *indices, uint32_t indexCount, uint32_t vertexCount)
+{
+	static const ScoreTables scores;
+	const uint32_t noTriangle = UINT32_MAX;
+
+	uint32_t triangleCount = indexCount / 3;
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// Vertex -> triangle adjacency, the first remaining[v] entries
+	// from triangleStart[v] are the triangles not yet emitted
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	std::vector<uint32_t> triangleStart(vertexCount + 1, 0);
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+
+	for (uint32_t i = 0; i < triangleCount * 3; i++)
+	{
+		assert(indices[i] < vertexCount && "index out of range");
+		remaining[indices[i]]++;
+	}
+
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		triangleStart[v + 1] = triangleStart[v] + remaining[v];
+	}
+
+	{
+		std::vector<uint32_t> cursor(triangleStart.begin(), triangleStart.end() - 1);
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+		{
+			adjacency[cursor[indices[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<int32_t> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		vertexScore[v] = scores.Score(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	uint32_t best = 0;
+
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		const uint32_t *tri = indices + t * 3;
+		triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+
+		if (triangleScore[t] > triangleScore[best])
+		{
+			best = t;
+		}
+	}
+
+	std::vector<uint32_t> output(triangleCount * 3);
+	uint32_t cache[C_ScoreCacheSize + 3];
+	uint32_t cacheCount = 0;
+	uint32_t scanCursor = 0;
+
+	for (uint32_t outTri = 0; outTri < triangleCount; outTri++)
+	{
+		// Nothing in the cache has work left, fall back to the next unused triangle
+		if (best == noTriangle)
+		{
+			while (emitted[scanCursor])
+			{
+				scanCursor++;
+			}
+			best = scanCursor;
+		}
+
+		const uint32_t *tri = indices + best * 3;
+		uint32_t newCache[C_ScoreCacheSize + 3];
+		uint32_t newCount = 0;
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t v = tri[k];
+			output[outTri * 3 + k] = v;
+
+			// Drop best from this vertex's remaining triangles
+			uint32_t *first = &adjacency[triangleStart[v]];
+			uint32_t *last = first + remaining[v] - 1;
+			uint32_t *found = std::find(first, last + 1, best);
+			assert(found <= last && "triangle missing from adjacency");
+			std::swap(*found, *last);
+			remaining[v]--;
+
+			if (std::find(newCache, newCache + newCount, v) == newCache + newCount)
+			{
+				newCache[newCount++] = v;
+			}
+		}
+		emitted[best] = true;
+
+		// Triangle vertices go to the front, the rest shift back
+		for (uint32_t i = 0; i < cacheCount; i++)
+		{
+			uint32_t v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				newCache[newCount++] = v;
+			}
+		}
+
+		for (uint32_t i = 0; i < newCount; i++)
+		{
+			uint32_t v = newCache[i];
+			cachePosition[v] = (i < C_ScoreCacheSize) ? static_cast<int32_t>(i) : -1;
+			vertexScore[v] = scores.Score(cachePosition[v], remaining[v]);
+		}
+
+		// Only triangles touching the cache change score, the best one goes next
+		best = noTriangle;
+		float bestScore = -1.0f;
+
+		for (uint32_t i = 0; i < newCount; i++)
+		{
+			uint32_t v = newCache[i];
+			for (uint32_t a = 0; a < remaining[v]; a++)
+			{
+				uint32_t t = adjacency[triangleStart[v] + a];
+				const uint32_t *adj = indices + t * 3;
+
+				triangleScore[t] = vertexScore[adj[0]] + vertexScore[adj[1]] + vertexScore[adj[2]];
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+
+		cacheCount = std::min(newCount, C_ScoreCacheSize);
+		std::memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+	}
+
+	for (uint32_t i = 0; i < triangleCount * 3; i++)
+	{
+		indices[i] = output[i];
+	}
+}
+
+void Learnings::OptimizeVertexCache(Mesh &mesh)
+{
+	OptimizeVertexCache(mesh.indices.data(),
+						static_cast<uint32_t>(mesh.indices.size()),
+						static_cast<uint32_t>(mesh.vertices.size()));
+}
+#pragma endregion
+
+#pragma region Vertex Fetch
+void Learnings::OptimizeVertexFetch(const MeshSpan &mesh)
+{
+	const uint32_t unused = UINT32_MAX;
+
+	// Old vertex index -> new vertex index, in order of first use
+	std::vector<uint32_t> remap(mesh.vertexCount, unused);
+	uint32_t nextVertex = 0;
+
+	for (uint32_t i = 0; i < mesh.indexCount; i++)
+	{
+		uint32_t &v = remap[mesh.indices[i]];
+		if (v == unused)
+		{
+			v = nextVertex++;
+		}
+		mesh.indices[i] = v;
+	}
+
+	for (uint32_t v = 0; v < mesh.vertexCount; v++)
+	{
+		if (remap[v] == unused)
+		{
+			remap[v] = nextVertex++;
+		}
+	}
+
+	std::vector<Vertex> source(mesh.vertices, mesh.vertices + mesh.vertexCount);
+	for (uint32_t v = 0; v < mesh.vertexCount; v++)
+	{
+		mesh.vertices[remap[v]] = source[v];
+	}
+}
+
+void Learnings::OptimizeVertexFetch(Mesh &mesh)
+{
+	OptimizeVertexFetch(MeshSpan{
+		mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()),
+		mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size())
+	});
+}
+#pragma endregion
+
+#pragma region Weld
+static uint64_t HashMix(uint64_t h)
+{
+	// splitmix64 finaliser
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ull;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBull;
+	h ^= h >> 31;
+
+	return h;
+}
+
+static uint32_t FloatBits(float f)
+{
+	// + 0.0f folds -0 into +0
+	f += 0.0f;
+
+	uint32_t bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+static bool Near(float a, float b, float epsilon)
+{
+	return std::fabs(a - b) <= epsilon;
+}
+
+uint32_t Learnings::WeldVertices(const MeshSpan &mesh, float epsilon, WeldKey key)
+{
+	const uint32_t empty = UINT32_MAX;
+	bool useTexCoord = (key == WeldKey::PositionTexCoord);
+
+	auto same = [&](const Vertex &a, const Vertex &b)
+	{
+		bool match = Near(a.position.x, b.position.x, epsilon)
+			&& Near(a.position.y, b.position.y, epsilon)
+			&& Near(a.position.z, b.position.z, epsilon);
+
+		if (useTexCoord)
+		{
+			match = match
+				&& Near(a.texCoord.x, b.texCoord.x, epsilon)
+				&& Near(a.texCoord.y, b.texCoord.y, epsilon);
+		}
+
+		return match;
+	};
+
+	// Power of two capacity at most half full, linear probing
+	uint32_t capacity = 16;
+	while (capacity < mesh.vertexCount * 2)
+	{
+		capacity *= 2;
+	}
+
+	struct Slot
+	{
+		uint64_t key;
+		uint32_t vertex;	// index of the welded vertex, already moved to its final place
+	};
+	std::vector<Slot> table(capacity, Slot{ 0, empty });
+
+	auto find = [&](const Vertex &v, uint64_t cell) -> uint32_t
+	{
+		for (uint32_t slot = static_cast<uint32_t>(cell) & (capacity - 1); table[slot].vertex != empty; slot = (slot + 1) & (capacity - 1))
+		{
+			if (table[slot].key == cell && same(mesh.vertices[table[slot].vertex], v))
+			{
+				return table[slot].vertex;
+			}
+		}
+
+		return empty;
+	};
+
+	auto insert = [&](uint64_t cell, uint32_t vertex)
+	{
+		uint32_t slot = static_cast<uint32_t>(cell) & (capacity - 1);
+		while (table[slot].vertex != empty)
+		{
+			slot = (slot + 1) & (capacity - 1);
+		}
+		table[slot] = { cell, vertex };
+	};
+
+	auto cellKey = [](int64_t x, int64_t y, int64_t z)
+	{
+		return HashMix(static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull
+					   ^ static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full
+					   ^ static_cast<uint64_t>(z) * 0x165667B19E3779F9ull);
+	};
+
+	std::vector<uint32_t> remap(mesh.vertexCount);
+	uint32_t weldedCount = 0;
+
+	// Epsilon welding hashes grid cells twice epsilon wide. Anything within
+	// epsilon is then in the vertex's own cell or the neighbour on the nearer side
+	// of each axis, 8 probes in all
+	float cellSize = 2.0f * epsilon;
+
+	for (uint32_t v = 0; v < mesh.vertexCount; v++)
+	{
+		const Vertex vertex = mesh.vertices[v];
+		uint32_t match = empty;
+		uint64_t ownCell;
+
+		if (epsilon > 0.0f)
+		{
+			float p[3] = { vertex.position.x / cellSize, vertex.position.y / cellSize, vertex.position.z / cellSize };
+			int64_t cell[3], side[3];
+			for (uint32_t axis = 0; axis < 3; axis++)
+			{
+				float base = std::floor(p[axis]);
+				cell[axis] = static_cast<int64_t>(base);
+				side[axis] = (p[axis] - base < 0.5f) ? -1 : 1;
+			}
+
+			ownCell = cellKey(cell[0], cell[1], cell[2]);
+			for (uint32_t n = 0; n < 8 && match == empty; n++)
+			{
+				match = find(vertex, cellKey(cell[0] + ((n & 1) ? side[0] : 0),
+											 cell[1] + ((n & 2) ? side[1] : 0),
+											 cell[2] + ((n & 4) ? side[2] : 0)));
+			}
+		}
+		else
+		{
+			// Exact welding hashes every compared bit, one probe finds all candidates
+			// Shifted unsigned, a set sign bit would overflow a signed shift
+			ownCell = cellKey(static_cast<int64_t>(FloatBits(vertex.position.x) | (static_cast<uint64_t>(FloatBits(vertex.position.y)) << 32)),
+							  FloatBits(vertex.position.z),
+							  useTexCoord ? static_cast<int64_t>(FloatBits(vertex.texCoord.x) | (static_cast<uint64_t>(FloatBits(vertex.texCoord.y)) << 32)) : 0);
+			match = find(vertex, ownCell);
+		}
+
+		if (match == empty)
+		{
+			// Survivors only ever move towards the front, so compacting in place is safe
+			match = weldedCount++;
+			mesh.vertices[match] = vertex;
+			insert(ownCell, match);
+		}
+
+		remap[v] = match;
+	}
+
+	for (uint32_t i = 0; i < mesh.indexCount; i++)
+	{
+		mesh.indices[i] = remap[mesh.indices[i]];
+	}
+
+	return weldedCount;
+}
+
+uint32_t Learnings::WeldVertices(Mesh &mesh, float epsilon, WeldKey key)
+{
+	uint32_t weldedCount = WeldVertices(MeshSpan{
+		mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()),
+		mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size())
+	}, epsilon, key);
+
+	mesh.vertices.resize(weldedCount);
+	if (mesh.indexFormat != DXGI_FORMAT_UNKNOWN)
+	{
+		mesh.indexFormat = IndexFormat(weldedCount);
+	}
+
+	return weldedCount;
+}
+#pragma endregion
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Learnings
+{
+	struct Mesh;
+	struct MeshSpan;
+
+	// Post-transform cache behaviour of an index list, from a FIFO cache simulation
+	struct VertexCacheStats
+	{
+		uint32_t transformCount;	// cache misses, each one runs the vertex shader
+		uint32_t triangleCount;
+		uint32_t vertexCount;		// distinct vertices referenced
+		float acmr;					// average cache miss ratio, transforms per triangle (0.5 is ideal)
+		float atvr;					// average transform to vertex ratio (1.0 is ideal)
+	};
+
+	// Memory traffic for vertex fetch, vertices are only fetched on a post-transform cache miss
+	struct VertexFetchStats
+	{
+		uint32_t bytesFetched;		// whole cache lines pulled from memory
+		float overfetch;			// bytesFetched over the size of all referenced vertices (1.0 is ideal)
+	};
+
+	// Typical post-transform cache size on the hardware we target
+	const uint32_t C_VertexCacheSize = 16;
+
+	VertexCacheStats AnalyzeVertexCache(const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = C_VertexCacheSize);
+	VertexCacheStats AnalyzeVertexCache(const Mesh &mesh, uint32_t cacheSize = C_VertexCacheSize);
+
+	// Reorder triangles in place for the post-transform cache (Tom Forsyth's linear-speed algorithm).
+	// Vertices are untouched, so this works on any triangle list.
+	void OptimizeVertexCache(uint32_t *indices, uint32_t indexCount, uint32_t vertexCount);
+	void OptimizeVertexCache(Mesh &mesh);
+
+	// Memory cache the fetch analysis models, lines of C_FetchLineSize bytes
+	const uint32_t C_FetchLineSize = 64;
+	const uint32_t C_FetchCacheLines = 256;
+
+	VertexFetchStats AnalyzeVertexFetch(const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t vertexSize);
+	VertexFetchStats AnalyzeVertexFetch(const Mesh &mesh);
+
+	// Reorder vertices by first use in the index list and rewrite the indices to match.
+	// Unreferenced vertices move to the end. Run after OptimizeVertexCache
+	void OptimizeVertexFetch(const MeshSpan &mesh);
+	void OptimizeVertexFetch(Mesh &mesh);
+
+	// Which attributes must match for two vertices to be welded
+	enum class WeldKey
+	{
+		PositionTexCoord,	// keeps UV seams
+		Position			// closes UV seams, for topology work
+	};
+
+	// Merge vertices that agree to within epsilon (0 means exactly equal) and remap the indices.
+	// Survivors keep their order in the vertex array, OptimizeVertexFetch puts them in first-use order.
+	// Linear time, through a spatial hash in an open-addressing table.
+	// Returns the new vertex count, the span's vertices past it are left as they were
+	uint32_t WeldVertices(const MeshSpan &mesh, float epsilon = 0.0f, WeldKey key = WeldKey::PositionTexCoord);
+	uint32_t WeldVertices(Mesh &mesh, float epsilon = 0.0f, WeldKey key = WeldKey::PositionTexCoord);
+}
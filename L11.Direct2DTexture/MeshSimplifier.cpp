@@ -0,0 +1,655 @@
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <DirectXMath.h>
+
+#include "MeshSimplifier.h"
+
+#include "MeshOptimizer.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+#pragma region Quadric
+// Sum of squared distances to a set of planes, as the symmetric 4x4 matrix
+// [a b c d]^T [a b c d] stored as its upper triangle
+struct Quadric
+{
+	double a2, ab, ac, ad,
+		b2, bc, bd,
+		c2, cd,
+		d2;
+	double weight;	// total plane area, turns the error back into a distance
+
+	static Quadric Plane(double a, double b, double c, double d, double weight)
+	{
+		return{
+			a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+			b * b * weight, b * c * weight, b * d * weight,
+			c * c * weight, c * d * weight,
+			d * d * weight,
+			weight
+		};
+	}
+
+	Quadric &operator+=(const Quadric &q)
+	{
+		a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+		b2 += q.b2; bc += q.bc; bd += q.bd;
+		c2 += q.c2; cd += q.cd;
+		d2 += q.d2;
+		weight += q.weight;
+
+		return *this;
+	}
+
+	// Weighted sum of squared distances from p to every plane
+	double Evaluate(const Math::XMFLOAT3 &p) const
+	{
+		double x = p.x, y = p.y, z = p.z;
+
+		return x * x * a2 + 2.0 * x * y * ab + 2.0 * x * z * ac + 2.0 * x * ad
+			+ y * y * b2 + 2.0 * y * z * bc + 2.0 * y * bd
+			+ z * z * c2 + 2.0 * z * cd
+			+ d2;
+	}
+};
+
+static Quadric operator+(Quadric q0, const Quadric &q1)
+{
+	return q0 += q1;
+}
+#pragma endregion
+
+#pragma region Simplifier
+// Half edge collapse simplifier over a mesh's position graph.
+// Vertices sharing a position (UV seams) form one position, collapses
+// move every triangle of the source position onto the target position.
+class Simplifier
+{
+public:
+	Simplifier(const Mesh &mesh);
+
+	// Collapse until at most targetTriangles are left or nothing can collapse
+	void Run(uint32_t targetTriangles);
+
+	// Current state as a mesh, referenced vertices only in first-use order
+	MeshLod Snapshot() const;
+
+	uint32_t TriangleCount() const { return m_AliveTriangles; }
+
+private:
+	struct Candidate
+	{
+		float error;
+		uint32_t from, to;
+		uint32_t fromVersion, toVersion;
+
+		bool operator>(const Candidate &c) const { return error > c.error; }
+	};
+
+	void Push(uint32_t from, uint32_t to);
+	bool Collapse(uint32_t from, uint32_t to);
+	bool Flips(uint32_t from, uint32_t to) const;
+	bool KeepsManifold(uint32_t from, uint32_t to);
+	void Retry(uint32_t p);
+
+	const Mesh &m_Mesh;
+
+	std::vector<uint32_t> m_PositionOf;				// vertex -> position
+	std::vector<Math::XMFLOAT3> m_Positions;
+	std::vector<Quadric> m_Quadrics;
+	std::vector<std::vector<uint32_t>> m_Triangles;	// position -> triangles, may hold dead ones
+	std::vector<bool> m_Locked;						// open border, never collapsed away
+	std::vector<bool> m_Removed;
+	std::vector<uint32_t> m_Version;				// bumped whenever a position's quadric changes
+	std::vector<std::vector<uint32_t>> m_Blocked;	// position -> targets it was refused, retried when its ring changes
+
+	std::vector<uint32_t> m_Indices;				// 3 per triangle, into mesh vertices
+	std::vector<bool> m_Dead;
+	uint32_t m_AliveTriangles;
+
+	std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> m_Queue;
+	float m_Error;
+	uint32_t m_SourceTriangles;
+
+	std::vector<uint32_t> m_FromRing, m_ToRing, m_EdgeApexes;	// scratch for KeepsManifold
+	std::vector<std::pair<uint32_t, uint32_t>> m_Moves;		// scratch for Collapse, from vertex -> to vertex
+};
+
+static Math::XMVECTOR TriangleNormal(const Math::XMFLOAT3 &p0, const Math::XMFLOAT3 &p1, const Math::XMFLOAT3 &p2)
+{
+	Math::XMVECTOR v0 = Math::XMLoadFloat3(&p0);
+	Math::XMVECTOR e1 = Math::XMVectorSubtract(Math::XMLoadFloat3(&p1), v0);
+	Math::XMVECTOR e2 = Math::XMVectorSubtract(Math::XMLoadFloat3(&p2), v0);
+
+	// Length is twice the triangle area
+	return Math::XMVector3Cross(e1, e2);
+}
+
+Simplifier::Simplifier(const Mesh &mesh)
+	: m_Mesh(mesh),
+	m_Indices(mesh.indices.begin(), mesh.indices.begin() + mesh.indices.size() / 3 * 3),
+	m_AliveTriangles((uint32_t)mesh.indices.size() / 3),
+	m_Error(0.0f),
+	m_SourceTriangles((uint32_t)mesh.indices.size() / 3)
+{
+	uint32_t vertexCount = (uint32_t)mesh.vertices.size();
+
+	// Position welding over an identity index list leaves each vertex's position id in it.
+	// Seam copies come out of different arithmetic in the generators, so weld to a fraction of the extent
+	float epsilon = 0.0f;
+	if (vertexCount > 0)
+	{
+		Bounds bounds = ComputeBounds(mesh.vertices.data(), vertexCount);
+		float extent = std::max(bounds.boxMax.x - bounds.boxMin.x, std::max(bounds.boxMax.y - bounds.boxMin.y, bounds.boxMax.z - bounds.boxMin.z));
+		epsilon = extent * 1e-6f;
+	}
+
+	std::vector<Vertex> unique(mesh.vertices);
+	m_PositionOf.resize(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		m_PositionOf[v] = v;
+	}
+	uint32_t positionCount = WeldVertices(MeshSpan{ unique.data(), vertexCount, m_PositionOf.data(), vertexCount }, epsilon, WeldKey::Position);
+
+	m_Positions.resize(positionCount);
+	for (uint32_t p = 0; p < positionCount; p++)
+	{
+		m_Positions[p] = unique[p].position;
+	}
+
+	m_Quadrics.assign(positionCount, Quadric{});
+	m_Triangles.resize(positionCount);
+	m_Locked.assign(positionCount, false);
+	m_Removed.assign(positionCount, false);
+	m_Version.assign(positionCount, 0);
+	m_Blocked.resize(positionCount);
+	m_Dead.assign(m_AliveTriangles, false);
+
+	// Edges used once are open borders. An edge whose triangles reach it through different
+	// vertices is a UV seam, which may only slide along itself
+	struct EdgeUse
+	{
+		uint32_t count;
+		uint32_t v0, v1;	// vertices of the first triangle, ordered by position
+		bool seam;
+	};
+	std::unordered_map<uint64_t, EdgeUse> edgeUse;
+	edgeUse.reserve(m_AliveTriangles * 3);
+
+	auto edgeKey = [](uint32_t p0, uint32_t p1)
+	{
+		return (static_cast<uint64_t>(std::min(p0, p1)) << 32) | std::max(p0, p1);
+	};
+
+	std::vector<Math::XMFLOAT3> normals(m_AliveTriangles);
+	for (uint32_t t = 0; t < m_AliveTriangles; t++)
+	{
+		uint32_t p[3] = {
+			m_PositionOf[m_Indices[t * 3]],
+			m_PositionOf[m_Indices[t * 3 + 1]],
+			m_PositionOf[m_Indices[t * 3 + 2]]
+		};
+
+		Math::XMVECTOR n = TriangleNormal(m_Positions[p[0]], m_Positions[p[1]], m_Positions[p[2]]);
+		float doubleArea = Math::XMVectorGetX(Math::XMVector3Length(n));
+		Math::XMStoreFloat3(&normals[t], n);
+
+		if (doubleArea > 0.0f)
+		{
+			Math::XMFLOAT3 unit;
+			Math::XMStoreFloat3(&unit, Math::XMVectorScale(n, 1.0f / doubleArea));
+			double d = -(unit.x * m_Positions[p[0]].x + unit.y * m_Positions[p[0]].y + unit.z * m_Positions[p[0]].z);
+
+			Quadric q = Quadric::Plane(unit.x, unit.y, unit.z, d, doubleArea * 0.5);
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				m_Quadrics[p[k]] += q;
+			}
+		}
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			m_Triangles[p[k]].push_back(t);
+
+			uint32_t v0 = m_Indices[t * 3 + k], v1 = m_Indices[t * 3 + (k + 1) % 3];
+			if (p[k] > p[(k + 1) % 3])
+			{
+				std::swap(v0, v1);
+			}
+
+			auto inserted = edgeUse.insert({ edgeKey(p[k], p[(k + 1) % 3]), { 1, v0, v1, false } });
+			if (!inserted.second)
+			{
+				EdgeUse &edge = inserted.first->second;
+				edge.count++;
+				edge.seam = edge.seam || edge.v0 != v0 || edge.v1 != v1;
+			}
+		}
+	}
+
+	for (auto &edge : edgeUse)
+	{
+		if (edge.second.count == 1)
+		{
+			m_Locked[static_cast<uint32_t>(edge.first >> 32)] = true;
+			m_Locked[static_cast<uint32_t>(edge.first)] = true;
+		}
+	}
+
+	// Seams hold their line through a plane along each seam edge at right angles to its triangle,
+	// weighted by the edge's length squared to match the area weights of the surface planes
+	for (uint32_t t = 0; t < m_AliveTriangles; t++)
+	{
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t p0 = m_PositionOf[m_Indices[t * 3 + k]], p1 = m_PositionOf[m_Indices[t * 3 + (k + 1) % 3]];
+			if (!edgeUse[edgeKey(p0, p1)].seam)
+			{
+				continue;
+			}
+
+			Math::XMVECTOR a = Math::XMLoadFloat3(&m_Positions[p0]);
+			Math::XMVECTOR along = Math::XMVectorSubtract(Math::XMLoadFloat3(&m_Positions[p1]), a);
+			Math::XMVECTOR side = Math::XMVector3Cross(along, Math::XMLoadFloat3(&normals[t]));
+			float sideLength = Math::XMVectorGetX(Math::XMVector3Length(side));
+			float lengthSquared = Math::XMVectorGetX(Math::XMVector3LengthSq(along));
+			if (sideLength <= 0.0f)
+			{
+				continue;
+			}
+			side = Math::XMVectorScale(side, 1.0f / sideLength);
+
+			Math::XMFLOAT3 unit;
+			Math::XMStoreFloat3(&unit, side);
+			double d = -Math::XMVectorGetX(Math::XMVector3Dot(side, a));
+
+			// Adds error but no area, so distances stay measured against the surface
+			Quadric q = Quadric::Plane(unit.x, unit.y, unit.z, d, lengthSquared);
+			q.weight = 0.0;
+			m_Quadrics[p0] += q;
+			m_Quadrics[p1] += q;
+		}
+	}
+
+	for (auto &edge : edgeUse)
+	{
+		uint32_t p0 = static_cast<uint32_t>(edge.first >> 32), p1 = static_cast<uint32_t>(edge.first);
+		Push(p0, p1);
+		Push(p1, p0);
+	}
+}
+
+void Simplifier::Push(uint32_t from, uint32_t to)
+{
+	if (m_Locked[from] || from == to)
+	{
+		return;
+	}
+
+	Quadric q = m_Quadrics[from] + m_Quadrics[to];
+	double error = std::max(q.Evaluate(m_Positions[to]), 0.0);
+	double distance = (q.weight > 0.0) ? std::sqrt(error / q.weight) : 0.0;
+
+	m_Queue.push({ static_cast<float>(distance), from, to, m_Version[from], m_Version[to] });
+}
+
+// Would moving from onto to turn any surviving triangle over or flatten it
+bool Simplifier::Flips(uint32_t from, uint32_t to) const
+{
+	for (auto t : m_Triangles[from])
+	{
+		if (m_Dead[t])
+		{
+			continue;
+		}
+
+		uint32_t p[3];
+		bool hasTo = false;
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			p[k] = m_PositionOf[m_Indices[t * 3 + k]];
+			hasTo = hasTo || (p[k] == to);
+		}
+
+		// Triangles on the edge disappear
+		if (hasTo)
+		{
+			continue;
+		}
+
+		Math::XMVECTOR before = TriangleNormal(m_Positions[p[0]], m_Positions[p[1]], m_Positions[p[2]]);
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			p[k] = (p[k] == from) ? to : p[k];
+		}
+		Math::XMVECTOR after = TriangleNormal(m_Positions[p[0]], m_Positions[p[1]], m_Positions[p[2]]);
+
+		float dot = Math::XMVectorGetX(Math::XMVector3Dot(before, after));
+		float lengths = Math::XMVectorGetX(Math::XMVector3Length(before)) * Math::XMVectorGetX(Math::XMVector3Length(after));
+
+		// More than ~80 degrees of turn, or collapsed to a sliver
+		if (lengths <= 0.0f || dot < 0.2f * lengths)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Link condition: the positions next to both ends must be exactly the far corners of the triangles on the edge,
+// otherwise the collapse would fold two sheets together and leave edges with more than two triangles
+bool Simplifier::KeepsManifold(uint32_t from, uint32_t to)
+{
+	m_FromRing.clear();
+	m_ToRing.clear();
+	m_EdgeApexes.clear();
+
+	auto gather = [&](uint32_t centre, std::vector<uint32_t> &ring, bool apexes)
+	{
+		for (auto t : m_Triangles[centre])
+		{
+			if (m_Dead[t])
+			{
+				continue;
+			}
+
+			uint32_t p[3];
+			bool hasFrom = false, hasTo = false;
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				p[k] = m_PositionOf[m_Indices[t * 3 + k]];
+				hasFrom = hasFrom || (p[k] == from);
+				hasTo = hasTo || (p[k] == to);
+			}
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				if (p[k] != from && p[k] != to)
+				{
+					ring.push_back(p[k]);
+					if (apexes && hasFrom && hasTo)
+					{
+						m_EdgeApexes.push_back(p[k]);
+					}
+				}
+			}
+		}
+
+		std::sort(ring.begin(), ring.end());
+		ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+	};
+
+	gather(from, m_FromRing, true);
+	gather(to, m_ToRing, false);
+
+	std::sort(m_EdgeApexes.begin(), m_EdgeApexes.end());
+	if (std::adjacent_find(m_EdgeApexes.begin(), m_EdgeApexes.end()) != m_EdgeApexes.end())
+	{
+		// Two triangles on the edge share their far corner, they would collapse into one another
+		return false;
+	}
+
+	// Common neighbours, both rings are sorted
+	size_t i = 0, j = 0, apex = 0;
+	while (i < m_FromRing.size() && j < m_ToRing.size())
+	{
+		if (m_FromRing[i] < m_ToRing[j])
+		{
+			i++;
+		}
+		else if (m_ToRing[j] < m_FromRing[i])
+		{
+			j++;
+		}
+		else
+		{
+			if (apex == m_EdgeApexes.size() || m_EdgeApexes[apex] != m_FromRing[i])
+			{
+				return false;
+			}
+
+			apex++;
+			i++;
+			j++;
+		}
+	}
+
+	return apex == m_EdgeApexes.size();
+}
+
+bool Simplifier::Collapse(uint32_t from, uint32_t to)
+{
+	if (Flips(from, to) || !KeepsManifold(from, to))
+	{
+		return false;
+	}
+
+	// Each vertex of from moves onto the vertex of to in its own UV chart, read off the triangles on the edge.
+	// On a seam both charts must reach to, so seams only collapse along themselves
+	m_Moves.clear();
+	for (auto t : m_Triangles[from])
+	{
+		if (m_Dead[t])
+		{
+			continue;
+		}
+
+		uint32_t fromVertex = UINT32_MAX, toVertex = UINT32_MAX;
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t v = m_Indices[t * 3 + k];
+			if (m_PositionOf[v] == from)
+			{
+				fromVertex = v;
+			}
+			else if (m_PositionOf[v] == to)
+			{
+				toVertex = v;
+			}
+		}
+
+		auto move = std::find_if(m_Moves.begin(), m_Moves.end(), [&](const std::pair<uint32_t, uint32_t> &m) { return m.first == fromVertex; });
+		if (move == m_Moves.end())
+		{
+			m_Moves.push_back({ fromVertex, toVertex });
+		}
+		else if (move->second == UINT32_MAX)
+		{
+			move->second = toVertex;
+		}
+		else if (toVertex != UINT32_MAX && toVertex != move->second)
+		{
+			return false;
+		}
+	}
+
+	for (auto &move : m_Moves)
+	{
+		if (move.second == UINT32_MAX)
+		{
+			return false;
+		}
+	}
+
+	for (auto t : m_Triangles[from])
+	{
+		if (m_Dead[t])
+		{
+			continue;
+		}
+
+		uint32_t *tri = &m_Indices[t * 3];
+		bool hasTo = m_PositionOf[tri[0]] == to || m_PositionOf[tri[1]] == to || m_PositionOf[tri[2]] == to;
+
+		if (hasTo)
+		{
+			m_Dead[t] = true;
+			m_AliveTriangles--;
+			continue;
+		}
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			for (auto &move : m_Moves)
+			{
+				if (tri[k] == move.first)
+				{
+					tri[k] = move.second;
+					break;
+				}
+			}
+		}
+		m_Triangles[to].push_back(t);
+	}
+
+	m_Removed[from] = true;
+	m_Triangles[from].clear();
+	m_Blocked[from].clear();
+	m_Quadrics[to] += m_Quadrics[from];
+	m_Version[to]++;
+
+	// Drop dead triangles from to, then requeue its edges with the new quadric
+	auto &triangles = m_Triangles[to];
+	triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](uint32_t t) { return m_Dead[t]; }), triangles.end());
+
+	for (auto t : triangles)
+	{
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t p = m_PositionOf[m_Indices[t * 3 + k]];
+			if (p != to)
+			{
+				Push(p, to);
+				Push(to, p);
+				Retry(p);
+			}
+		}
+	}
+	Retry(to);
+
+	return true;
+}
+
+void Simplifier::Run(uint32_t targetTriangles)
+{
+	while (m_AliveTriangles > targetTriangles && !m_Queue.empty())
+	{
+		Candidate c = m_Queue.top();
+		m_Queue.pop();
+
+		// Stale: an end is gone or its quadric has grown since this was queued
+		if (m_Removed[c.from] || m_Removed[c.to] || c.fromVersion != m_Version[c.from] || c.toVersion != m_Version[c.to])
+		{
+			continue;
+		}
+
+		if (Collapse(c.from, c.to))
+		{
+			m_Error = std::max(m_Error, c.error);
+		}
+		else
+		{
+			m_Blocked[c.from].push_back(c.to);
+		}
+	}
+}
+
+// Requeue what was refused at p, a collapse next to it may have made those valid
+void Simplifier::Retry(uint32_t p)
+{
+	for (auto to : m_Blocked[p])
+	{
+		if (!m_Removed[to])
+		{
+			Push(p, to);
+		}
+	}
+	m_Blocked[p].clear();
+}
+
+MeshLod Simplifier::Snapshot() const
+{
+	MeshLod lod;
+	lod.error = m_Error;
+	lod.ratio = (m_SourceTriangles > 0) ? static_cast<float>(m_AliveTriangles) / m_SourceTriangles : 1.0f;
+
+	std::vector<uint32_t> remap(m_Mesh.vertices.size(), UINT32_MAX);
+	lod.mesh.indices.reserve(m_AliveTriangles * 3);
+
+	for (uint32_t t = 0; t < m_Dead.size(); t++)
+	{
+		if (m_Dead[t])
+		{
+			continue;
+		}
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t v = m_Indices[t * 3 + k];
+			if (remap[v] == UINT32_MAX)
+			{
+				remap[v] = (uint32_t)lod.mesh.vertices.size();
+				lod.mesh.vertices.push_back(m_Mesh.vertices[v]);
+			}
+			lod.mesh.indices.push_back(remap[v]);
+		}
+	}
+
+	lod.mesh.indexFormat = IndexFormat((uint32_t)lod.mesh.vertices.size());
+	lod.mesh.UpdateBounds();
+
+	return lod;
+}
+#pragma endregion
+
+std::vector<MeshLod> Learnings::BuildLods(const Mesh &mesh, const std::vector<float> &ratios)
+{
+	Simplifier simplifier(mesh);
+	uint32_t triangleCount = simplifier.TriangleCount();
+
+	std::vector<MeshLod> lods;
+	lods.reserve(ratios.size());
+
+	for (auto ratio : ratios)
+	{
+		assert((lods.empty() || ratio <= ratios[lods.size() - 1]) && "LOD ratios must decrease");
+
+		simplifier.Run(static_cast<uint32_t>(triangleCount * ratio));
+		lods.push_back(simplifier.Snapshot());
+	}
+
+	return lods;
+}
+
+MeshLod Learnings::Simplify(const Mesh &mesh, uint32_t targetIndexCount)
+{
+	Simplifier simplifier(mesh);
+	simplifier.Run(targetIndexCount / 3);
+
+	return simplifier.Snapshot();
+}
+
+int Learnings::SelectLod(const std::vector<MeshLod> &lods, float distance, float scale, float pixelsPerUnit, float maxPixels)
+{
+	// Errors only grow along the chain, so stop at the first one that shows
+	int selected = -1;
+	for (size_t i = 0; i < lods.size(); i++)
+	{
+		float pixels = lods[i].error * scale * pixelsPerUnit / std::max(distance, 1e-6f);
+		if (pixels > maxPixels)
+		{
+			break;
+		}
+		selected = static_cast<int>(i);
+	}
+
+	return selected;
+}
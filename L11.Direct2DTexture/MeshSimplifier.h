@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+namespace Learnings
+{
+	// One level of detail and how far it strays from the source mesh
+	struct MeshLod
+	{
+		Mesh mesh;
+		float error;	// largest collapse error so far, in mesh units (distance to the original surface)
+		float ratio;	// triangles over the source mesh's, above the asked ratio when collapses ran out
+	};
+
+	// Build LODs by quadric error edge collapse (Garland-Heckbert), one pass for the whole chain.
+	// ratios are target triangle counts relative to mesh, in decreasing order (e.g. 0.5, 0.25, 0.125).
+	// Collapses only move a vertex onto a neighbour, so UVs stay valid, and only where the surface stays
+	// manifold. Positions are welded to within a millionth of the mesh's extent first, so a generator's seam copies
+	// that differ in the last bits are one position. UV seams only collapse along themselves, with every
+	// chart's copy moving together, and open borders are kept in place, so a LOD can stop short of its target,
+	// its ratio says how far it got
+	std::vector<MeshLod> BuildLods(const Mesh &mesh, const std::vector<float> &ratios);
+
+	// Single LOD with at most targetIndexCount indices
+	MeshLod Simplify(const Mesh &mesh, uint32_t targetIndexCount);
+
+	// Coarsest LOD whose error projects to at most maxPixels on screen, -1 when even lods[0] is too coarse.
+	// pixelsPerUnit is the screen height in pixels over 2 * tan(fovY / 2), scale is the mesh's world scale
+	int SelectLod(const std::vector<MeshLod> &lods, float distance, float scale, float pixelsPerUnit, float maxPixels = 1.0f);
+}
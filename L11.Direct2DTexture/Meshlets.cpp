@@ -0,0 +1,361 @@
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+#include "Meshlets.h"
+
+#include "Mesh.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+#pragma region Build
+// Sphere around the meshlet's vertices and the cone its front face normals fall in
+static void ComputeMeshletBounds(Meshlet &meshlet, const Vertex *vertices, const uint32_t *indices)
+{
+	const uint32_t *first = indices + meshlet.indexOffset;
+	const uint32_t *last = first + meshlet.indexCount;
+
+	// Box center, then the farthest vertex from it
+	Math::XMVECTOR lo = Math::XMLoadFloat3(&vertices[*first].position);
+	Math::XMVECTOR hi = lo;
+	for (const uint32_t *i = first; i != last; i++)
+	{
+		Math::XMVECTOR p = Math::XMLoadFloat3(&vertices[*i].position);
+		lo = Math::XMVectorMin(lo, p);
+		hi = Math::XMVectorMax(hi, p);
+	}
+
+	Math::XMVECTOR center = Math::XMVectorScale(Math::XMVectorAdd(lo, hi), 0.5f);
+	Math::XMVECTOR radiusSq = Math::XMVectorZero();
+	for (const uint32_t *i = first; i != last; i++)
+	{
+		Math::XMVECTOR p = Math::XMLoadFloat3(&vertices[*i].position);
+		radiusSq = Math::XMVectorMax(radiusSq, Math::XMVector3LengthSq(Math::XMVectorSubtract(p, center)));
+	}
+
+	Math::XMStoreFloat3(&meshlet.center, center);
+	meshlet.radius = std::sqrt(Math::XMVectorGetX(radiusSq));
+
+	// Front faces are clockwise seen from outside, so (p1 - p0) x (p2 - p0) points out in left handed space
+	std::vector<Math::XMVECTOR> normals;
+	normals.reserve(meshlet.indexCount / 3);
+
+	Math::XMVECTOR axis = Math::XMVectorZero();
+	for (const uint32_t *i = first; i != last; i += 3)
+	{
+		Math::XMVECTOR p0 = Math::XMLoadFloat3(&vertices[i[0]].position);
+		Math::XMVECTOR p1 = Math::XMLoadFloat3(&vertices[i[1]].position);
+		Math::XMVECTOR p2 = Math::XMLoadFloat3(&vertices[i[2]].position);
+		Math::XMVECTOR n = Math::XMVector3Cross(Math::XMVectorSubtract(p1, p0), Math::XMVectorSubtract(p2, p0));
+
+		float length = Math::XMVectorGetX(Math::XMVector3Length(n));
+		if (length > 0.0f)
+		{
+			n = Math::XMVectorScale(n, 1.0f / length);
+			normals.push_back(n);
+			axis = Math::XMVectorAdd(axis, n);
+		}
+	}
+
+	meshlet.coneAxis = Math::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	meshlet.coneCutoff = 1.0f;
+
+	float axisLength = Math::XMVectorGetX(Math::XMVector3Length(axis));
+	if (normals.empty() || axisLength <= 0.0f)
+	{
+		return;
+	}
+
+	axis = Math::XMVectorScale(axis, 1.0f / axisLength);
+	Math::XMStoreFloat3(&meshlet.coneAxis, axis);
+
+	float minDot = 1.0f;
+	for (auto &n : normals)
+	{
+		minDot = std::min(minDot, Math::XMVectorGetX(Math::XMVector3Dot(n, axis)));
+	}
+
+	// Normals spread past ~84 degrees from the axis leave no view direction that hides them all.
+	// Otherwise widen the cone by 90 degrees to get the view directions that see only back faces:
+	// cos(angle + 90) = -sin(angle)
+	if (minDot > 0.1f)
+	{
+		meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+}
+
+std::vector<Meshlet> Learnings::BuildMeshlets(const MeshSpan &mesh)
+{
+	uint32_t triangleCount = mesh.indexCount / 3;
+	const uint32_t *indices = mesh.indices;
+
+	// Vertex -> triangle adjacency, emitted triangles are skipped rather than removed
+	std::vector<uint32_t> triangleStart(mesh.vertexCount + 1, 0);
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+
+	for (uint32_t i = 0; i < triangleCount * 3; i++)
+	{
+		assert(indices[i] < mesh.vertexCount && "index out of range");
+		triangleStart[indices[i] + 1]++;
+	}
+
+	for (uint32_t v = 0; v < mesh.vertexCount; v++)
+	{
+		triangleStart[v + 1] += triangleStart[v];
+	}
+
+	{
+		std::vector<uint32_t> cursor(triangleStart.begin(), triangleStart.end() - 1);
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+		{
+			adjacency[cursor[indices[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<uint32_t> remaining(mesh.vertexCount);
+	for (uint32_t v = 0; v < mesh.vertexCount; v++)
+	{
+		remaining[v] = triangleStart[v + 1] - triangleStart[v];
+	}
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+
+	// Vertex is in the current meshlet when its tag is the meshlet count + 1
+	std::vector<uint32_t> vertexTag(mesh.vertexCount, 0);
+	std::vector<uint32_t> meshletVertices;
+	meshletVertices.reserve(C_MeshletMaxVertices);
+
+	std::vector<Meshlet> meshlets;
+	uint32_t seedCursor = 0;
+
+	auto newVertexCount = [&](uint32_t t, uint32_t tag)
+	{
+		const uint32_t *tri = indices + t * 3;
+		return (vertexTag[tri[0]] != tag ? 1u : 0u)
+			+ (vertexTag[tri[1]] != tag && tri[1] != tri[0] ? 1u : 0u)
+			+ (vertexTag[tri[2]] != tag && tri[2] != tri[0] && tri[2] != tri[1] ? 1u : 0u);
+	};
+
+	uint32_t seed = UINT32_MAX;
+
+	while (true)
+	{
+		// Next meshlet starts beside the last one when it can, otherwise at the earliest triangle left
+		if (seed == UINT32_MAX)
+		{
+			while (seedCursor < triangleCount && emitted[seedCursor])
+			{
+				seedCursor++;
+			}
+			if (seedCursor == triangleCount)
+			{
+				break;
+			}
+			seed = seedCursor;
+		}
+
+		Meshlet meshlet{};
+		meshlet.indexOffset = static_cast<uint32_t>(output.size());
+
+		uint32_t tag = static_cast<uint32_t>(meshlets.size()) + 1;
+		uint32_t triangles = 0;
+		uint32_t next = seed;
+		meshletVertices.clear();
+		Math::XMVECTOR positionSum = Math::XMVectorZero();
+
+		while (next != UINT32_MAX)
+		{
+			emitted[next] = true;
+			triangles++;
+			remaining[indices[next * 3]]--;
+			remaining[indices[next * 3 + 1]]--;
+			remaining[indices[next * 3 + 2]]--;
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[next * 3 + k];
+				output.push_back(v);
+
+				if (vertexTag[v] != tag)
+				{
+					vertexTag[v] = tag;
+					meshletVertices.push_back(v);
+					positionSum = Math::XMVectorAdd(positionSum, Math::XMLoadFloat3(&mesh.vertices[v].position));
+				}
+			}
+
+			if (triangles == C_MeshletMaxTriangles)
+			{
+				break;
+			}
+
+			// Neighbouring triangle that adds the fewest vertices, then the one whose vertices have the fewest
+			// triangles left (closes the surface off behind the meshlet rather than leaving holes),
+			// then the one nearest the centroid to keep meshlets round.
+			// Only triangles touching the meshlet are considered, so meshlets stay connected
+			Math::XMVECTOR centroid = Math::XMVectorScale(positionSum, 1.0f / meshletVertices.size());
+			next = UINT32_MAX;
+			uint32_t bestNew = 4;
+			uint32_t bestLive = UINT32_MAX;
+			float bestDistance = 0.0f;
+			for (auto v : meshletVertices)
+			{
+				for (uint32_t a = triangleStart[v]; a < triangleStart[v + 1]; a++)
+				{
+					uint32_t t = adjacency[a];
+					if (emitted[t])
+					{
+						continue;
+					}
+
+					uint32_t added = newVertexCount(t, tag);
+					if (added > bestNew || meshletVertices.size() + added > C_MeshletMaxVertices)
+					{
+						continue;
+					}
+
+					const uint32_t *tri = indices + t * 3;
+					uint32_t live = remaining[tri[0]] + remaining[tri[1]] + remaining[tri[2]];
+					if (added == bestNew && live > bestLive)
+					{
+						continue;
+					}
+
+					Math::XMVECTOR triangleCenter = Math::XMVectorAdd(Math::XMLoadFloat3(&mesh.vertices[tri[0]].position),
+						Math::XMVectorAdd(Math::XMLoadFloat3(&mesh.vertices[tri[1]].position), Math::XMLoadFloat3(&mesh.vertices[tri[2]].position)));
+					float distance = Math::XMVectorGetX(Math::XMVector3LengthSq(
+						Math::XMVectorSubtract(Math::XMVectorScale(triangleCenter, 1.0f / 3.0f), centroid)));
+
+					if (added < bestNew || live < bestLive || distance < bestDistance)
+					{
+						bestNew = added;
+						bestLive = live;
+						bestDistance = distance;
+						next = t;
+					}
+				}
+			}
+		}
+
+		meshlet.indexCount = triangles * 3;
+		meshlet.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+		meshlets.push_back(meshlet);
+
+		// Earliest triangle still touching the finished meshlet
+		seed = UINT32_MAX;
+		for (auto v : meshletVertices)
+		{
+			for (uint32_t a = triangleStart[v]; a < triangleStart[v + 1]; a++)
+			{
+				uint32_t t = adjacency[a];
+				if (!emitted[t] && t < seed)
+				{
+					seed = t;
+				}
+			}
+		}
+	}
+
+	// Indices past the last whole triangle stay where they are
+	for (uint32_t i = 0; i < output.size(); i++)
+	{
+		mesh.indices[i] = output[i];
+	}
+
+	for (auto &meshlet : meshlets)
+	{
+		ComputeMeshletBounds(meshlet, mesh.vertices, mesh.indices);
+	}
+
+	return meshlets;
+}
+
+std::vector<Meshlet> Learnings::BuildMeshlets(Mesh &mesh)
+{
+	return BuildMeshlets(MeshSpan{
+		mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()),
+		mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size())
+	});
+}
+#pragma endregion
+
+#pragma region Culling
+MeshletCuller::MeshletCuller(Math::FXMMATRIX meshToClip)
+	: m_Eye(0.0f, 0.0f, 0.0f),
+	m_HasEye(false)
+{
+	// Clip volume -w <= x <= w, -w <= y <= w, 0 <= z <= w, as planes on the matrix columns
+	Math::XMMATRIX columns = Math::XMMatrixTranspose(meshToClip);
+	Math::XMVECTOR planes[6] = {
+		Math::XMVectorAdd(columns.r[3], columns.r[0]),
+		Math::XMVectorSubtract(columns.r[3], columns.r[0]),
+		Math::XMVectorAdd(columns.r[3], columns.r[1]),
+		Math::XMVectorSubtract(columns.r[3], columns.r[1]),
+		columns.r[2],
+		Math::XMVectorSubtract(columns.r[3], columns.r[2])
+	};
+
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		// Unit normals, so plane distances compare with the radius
+		float length = Math::XMVectorGetX(Math::XMVector3Length(planes[i]));
+		Math::XMStoreFloat4(&m_Planes[i], Math::XMVectorScale(planes[i], (length > 0.0f) ? 1.0f / length : 0.0f));
+	}
+
+	// The eye maps to (0, 0, z, 0) in clip space, so it is row 2 of the inverse
+	Math::XMVECTOR determinant;
+	Math::XMMATRIX clipToMesh = Math::XMMatrixInverse(&determinant, meshToClip);
+	float w = Math::XMVectorGetW(clipToMesh.r[2]);
+
+	if (Math::XMVectorGetX(determinant) != 0.0f && std::fabs(w) > 1e-6f)
+	{
+		Math::XMStoreFloat3(&m_Eye, Math::XMVectorScale(clipToMesh.r[2], 1.0f / w));
+		m_HasEye = true;
+	}
+}
+
+bool MeshletCuller::Visible(const Math::XMFLOAT3 &center, float radius) const
+{
+	Math::XMVECTOR point = Math::XMVectorAdd(Math::XMLoadFloat3(&center), Math::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		float distance = Math::XMVectorGetX(Math::XMVector4Dot(Math::XMLoadFloat4(&m_Planes[i]), point));
+		if (distance < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool MeshletCuller::Visible(const Meshlet &meshlet) const
+{
+	if (!Visible(meshlet.center, meshlet.radius))
+	{
+		return false;
+	}
+
+	Math::XMVECTOR center = Math::XMLoadFloat3(&meshlet.center);
+
+	// Every triangle faces away when the eye looks down the cone from outside the sphere
+	if (m_HasEye && meshlet.coneCutoff < 1.0f)
+	{
+		Math::XMVECTOR view = Math::XMVectorSubtract(center, Math::XMLoadFloat3(&m_Eye));
+		float along = Math::XMVectorGetX(Math::XMVector3Dot(view, Math::XMLoadFloat3(&meshlet.coneAxis)));
+		float distance = Math::XMVectorGetX(Math::XMVector3Length(view));
+
+		if (along >= meshlet.coneCutoff * distance + meshlet.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+#pragma endregion
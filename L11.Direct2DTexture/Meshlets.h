@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <DirectXMath.h>
+
+namespace Learnings
+{
+	struct Mesh;
+	struct MeshSpan;
+
+	// Cluster limits, the usual mesh shader sizes
+	const uint32_t C_MeshletMaxVertices = 64;
+	const uint32_t C_MeshletMaxTriangles = 124;
+
+	// Cluster of triangles, a contiguous range of its mesh's index list
+	struct Meshlet
+	{
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		uint32_t vertexCount;			// distinct vertices referenced, at most C_MeshletMaxVertices
+
+		// Bounding sphere in mesh space
+		DirectX::XMFLOAT3 center;
+		float radius;
+
+		// Normal cone around the front face normals.
+		// coneCutoff is the sine of the cone's half angle, 1 when the cone is too wide to ever be culled
+		DirectX::XMFLOAT3 coneAxis;
+		float coneCutoff;
+	};
+
+	// Reorder triangles in place so each meshlet is a contiguous index range, and return the meshlets.
+	// Meshlets grow greedily through shared vertices, seeded in index order, so run after OptimizeVertexCache.
+	// Vertices are untouched
+	std::vector<Meshlet> BuildMeshlets(const MeshSpan &mesh);
+	std::vector<Meshlet> BuildMeshlets(Mesh &mesh);
+
+	// Frustum planes and eye position in mesh space, for testing one mesh instance's meshlets
+	class MeshletCuller
+	{
+	public:
+		// meshToClip is world * view * projection, not transposed
+		MeshletCuller(DirectX::FXMMATRIX meshToClip);
+
+		// False when the meshlet is outside the frustum or all its triangles face away from the eye
+		bool Visible(const Meshlet &meshlet) const;
+
+		// False when the sphere is outside the frustum
+		bool Visible(const DirectX::XMFLOAT3 &center, float radius) const;
+
+	private:
+		DirectX::XMFLOAT4 m_Planes[6];
+		DirectX::XMFLOAT3 m_Eye;
+		bool m_HasEye;					// orthographic projections have no eye point, only the frustum is tested
+	};
+}
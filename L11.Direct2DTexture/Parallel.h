@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <exception>
+
+namespace Learnings
+{
+	// Number of threads to use for threadCount, 0 means one per hardware thread
+	inline uint32_t ThreadCount(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		return threadCount;
+	}
+
+	// Split [0, count) into threadCount contiguous ranges and call fn(begin, end) for each.
+	// Ranges are fixed by count and threadCount only, so as long as fn writes
+	// only to slots it owns the result is identical to a single threaded run.
+	// The calling thread does the first range itself. Every started thread is joined before returning,
+	// then an exception thrown by fn is rethrown, the one from the lowest range if several threw,
+	// so a threaded run fails the way a single threaded one does
+	template <typename Fn>
+	void ParallelFor(uint32_t count, uint32_t threadCount, Fn fn)
+	{
+		threadCount = std::min(ThreadCount(threadCount), std::max(count, 1u));
+
+		if (threadCount == 1)
+		{
+			fn(0u, count);
+			return;
+		}
+
+		uint32_t chunk = count / threadCount;
+		uint32_t remainder = count % threadCount;
+
+		auto rangeBegin = [&](uint32_t t)
+		{
+			return t * chunk + std::min(t, remainder);
+		};
+
+		// One slot per range, each written only by the thread running it
+		std::vector<std::exception_ptr> errors(threadCount);
+		std::vector<std::thread> workers;
+
+		try
+		{
+			workers.reserve(threadCount - 1);
+
+			for (uint32_t t = 1; t < threadCount; t++)
+			{
+				uint32_t begin = rangeBegin(t);
+				uint32_t end = rangeBegin(t + 1);
+				workers.emplace_back([&errors, fn, t, begin, end]() mutable
+				{
+					try
+					{
+						fn(begin, end);
+					}
+					catch (...)
+					{
+						errors[t] = std::current_exception();
+					}
+				});
+			}
+
+			fn(rangeBegin(0), rangeBegin(1));
+		}
+		catch (...)
+		{
+			// fn on this thread, or a thread that could not be started
+			errors[0] = std::current_exception();
+		}
+
+		for (auto &worker : workers)
+		{
+			worker.join();
+		}
+
+		for (auto &error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+}
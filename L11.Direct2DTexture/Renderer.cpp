@@ -1,9 +1,11 @@
+#include <cassert>
 #include <algorithm>
 
 #include <DirectXColors.h>
 
 #include "Renderer.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
 
 using namespace Learnings;
 
@@ -81,6 +83,8 @@ Renderer::Renderer(HWND hWnd)
 {
 	m_d3d = std::make_unique<Learnings::Direct3d>(hWnd);
 
+	DirectX::XMStoreFloat4x4(&m_Projection, DirectX::XMMatrixIdentity());
+
 	CreateStates();
 
 	// Get DXGI device from D3D device
@@ -121,17 +125,22 @@ void Renderer::Draw()
 									  count,
 									  &(m_ProjectionBuffer.p));
 
+		// Uploaded matrices are transposed for HLSL
+		DirectX::XMMATRIX viewProjection = DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_Projection));
+
 		for (auto &mesh : m_Meshes)
 		{
+			D3D11_PRIMITIVE_TOPOLOGY topology = mesh.topology;
+
 			auto it = m_TopologyRules.find(mesh.id);
 			if (it != m_TopologyRules.end())
 			{
-				context->IASetPrimitiveTopology(it->second);
-			}
-			else
-			{
-				context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+				topology = it->second;
 			}
+			context->IASetPrimitiveTopology(topology);
+
+			// Meshlets are triangle ranges, any other topology draws everything
+			bool cullMeshlets = !mesh.meshlets.empty() && topology == D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
 			context->IASetVertexBuffers(0,
 										1,
@@ -139,18 +148,56 @@ void Renderer::Draw()
 										&Vertex::Size,
 										&vertexOffset);
 			context->IASetIndexBuffer(mesh.indexBuffer,
-									  DXGI_FORMAT_R32_UINT,
+									  mesh.indexFormat,
 									  indexOffset);
 
-			auto itRange = m_TransformBuffer.equal_range(mesh.id);
+			auto itRange = m_Instances.equal_range(mesh.id);
 			std::for_each(itRange.first, itRange.second, [&](auto& it)
 			{
-				auto transformBuffer = it.second;
+				auto &instance = it.second;
 				context->VSSetConstantBuffers(slot + 1,
 											  count,
-											  &(transformBuffer.p));
-
-				context->DrawIndexed(mesh.indexCount, 0, 0);
+											  &(instance.transformBuffer.p));
+
+				DirectX::XMMATRIX world = DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&instance.transform));
+				MeshletCuller culler(world * viewProjection);
+
+				if (!culler.Visible(mesh.bounds.center, mesh.bounds.radius))
+				{
+					return;
+				}
+
+				if (!cullMeshlets)
+				{
+					context->DrawIndexed(mesh.indexCount, 0, 0);
+					return;
+				}
+
+				// Meshlets are back to back in the index buffer, so visible neighbours share one draw
+				uint32_t runStart = 0, runCount = 0;
+				for (auto &meshlet : mesh.meshlets)
+				{
+					if (!culler.Visible(meshlet))
+					{
+						continue;
+					}
+
+					if (runCount > 0 && runStart + runCount != meshlet.indexOffset)
+					{
+						context->DrawIndexed(runCount, runStart, 0);
+						runCount = 0;
+					}
+					if (runCount == 0)
+					{
+						runStart = meshlet.indexOffset;
+					}
+					runCount += meshlet.indexCount;
+				}
+
+				if (runCount > 0)
+				{
+					context->DrawIndexed(runCount, runStart, 0);
+				}
 			});
 		}
 	}
@@ -162,7 +209,7 @@ void Renderer::Resize()
 	m_d3d->Resize();
 }
 
-void Renderer::AddGeometry(uint32_t meshId, const Mesh &mesh)
+RenderableMesh &Renderer::GetRenderableMesh(uint32_t meshId)
 {
 	uint32_t mId = (uint32_t)m_Meshes.size();
 
@@ -180,20 +227,193 @@ void Renderer::AddGeometry(uint32_t meshId, const Mesh &mesh)
 	auto &mo = m_Meshes[mId];
 
 	mo.id = mId;
+
+	return mo;
+}
+
+// Run the requested Renderer::MeshOptimization passes in place, returns the meshlets if they were built
+static std::vector<Meshlet> OptimizeMesh(const MeshSpan &mesh, uint32_t optimization)
+{
+	std::vector<Meshlet> meshlets;
+
+	if (optimization & Renderer::VertexCache)
+	{
+		OptimizeVertexCache(mesh.indices, mesh.indexCount, mesh.vertexCount);
+	}
+
+	// Only reorders triangles and reads positions, so fetch optimization after it keeps the meshlets valid
+	if (optimization & Renderer::Meshlets)
+	{
+		meshlets = BuildMeshlets(mesh);
+	}
+
+	if (optimization & Renderer::VertexFetch)
+	{
+		OptimizeVertexFetch(mesh);
+	}
+
+	return meshlets;
+}
+
+void Renderer::AddGeometry(uint32_t meshId, const Mesh &mesh, uint32_t optimization)
+{
+	uint32_t vertexCount = (uint32_t)mesh.vertices.size();
+	uint32_t indexCount = (uint32_t)mesh.indices.size();
+
+	DXGI_FORMAT indexFormat = mesh.indexFormat;
+	if (indexFormat == DXGI_FORMAT_UNKNOWN)
+	{
+		indexFormat = IndexFormat(vertexCount);
+	}
+	assert((indexFormat == DXGI_FORMAT_R32_UINT || vertexCount <= 0xFFFF) && "too many vertices for 16 bit indices");
+
+	// Passes would shuffle strip and line indices into garbage
+	if (mesh.topology != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)
+	{
+		optimization = None;
+	}
+
+	// Optimization and packing work in place, so they need a copy of caller's mesh
+	const Mesh *source = &mesh;
+	Mesh copy;
+	std::vector<Meshlet> meshlets;
+	if (optimization != None || indexFormat != DXGI_FORMAT_R32_UINT)
+	{
+		copy = mesh;
+		meshlets = OptimizeMesh(MeshSpan{
+			copy.vertices.data(), vertexCount,
+			copy.indices.data(), indexCount
+		}, optimization);
+		PackIndices(copy.indices.data(), indexCount, indexFormat);
+		source = &copy;
+	}
+
+	auto &mo = GetRenderableMesh(meshId);
 	
-	mo.vertexBuffer = m_d3d->CreateBuffer((uint32_t)mesh.vertices.size() * Vertex::Size,
-										 mesh.vertices.data(),
+	mo.vertexBuffer = m_d3d->CreateBuffer(vertexCount * Vertex::Size,
+										 source->vertices.data(),
 										 D3D11_BIND_VERTEX_BUFFER,
 										 D3D11_USAGE_DEFAULT,
 										 NULL);
 
-	mo.indexBuffer = m_d3d->CreateBuffer((uint32_t)mesh.indices.size() * sizeof(uint32_t),
-										mesh.indices.data(),
+	mo.indexBuffer = m_d3d->CreateBuffer(indexCount * IndexSize(indexFormat),
+										source->indices.data(),
 										D3D11_BIND_INDEX_BUFFER,
 										D3D11_USAGE_DEFAULT,
 										NULL);
 	
-	mo.indexCount = (uint32_t)mesh.indices.size();
+	mo.indexFormat = indexFormat;
+	mo.indexCount = indexCount;
+	mo.topology = mesh.topology;
+	mo.meshlets = std::move(meshlets);
+	mo.bounds = ComputeBounds(source->vertices.data(), vertexCount);
+}
+
+// Streaming path, generator writes straight into mapped staging memory
+// which is then copied to the default usage buffers on the GPU,
+// so the mesh never exists in system memory as a separate copy.
+// Optimization passes and 16 bit packing run on the mapped memory too, which then has to be readable.
+void Renderer::AddGeometry(uint32_t meshId, const MeshSize &size, const MeshGenerator &generator,
+						   D3D11_PRIMITIVE_TOPOLOGY topology, uint32_t optimization)
+{
+	if (topology != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)
+	{
+		optimization = None;
+	}
+
+	// Generators always write 32 bit indices, they are packed afterwards
+	DXGI_FORMAT indexFormat = IndexFormat(size.vertexCount);
+
+	uint32_t vbSize = size.vertexCount * Vertex::Size;
+	uint32_t ibSize = size.indexCount * sizeof(uint32_t);
+	uint32_t ibPackedSize = size.indexCount * IndexSize(indexFormat);
+
+	// Index passes read the index buffer back, vertices are always read for the bounds
+	bool readBackIndices = (optimization != None || indexFormat != DXGI_FORMAT_R32_UINT);
+
+	auto vbStaging = m_d3d->CreateBuffer(vbSize,
+										 NULL,
+										 (D3D11_BIND_FLAG)0,
+										 D3D11_USAGE_STAGING,
+										 D3D11_CPU_ACCESS_READ | D3D11_CPU_ACCESS_WRITE);
+
+	auto ibStaging = m_d3d->CreateBuffer(ibSize,
+										 NULL,
+										 (D3D11_BIND_FLAG)0,
+										 D3D11_USAGE_STAGING,
+										 readBackIndices ? D3D11_CPU_ACCESS_READ | D3D11_CPU_ACCESS_WRITE : D3D11_CPU_ACCESS_WRITE);
+
+	auto context = m_d3d->GetContext();
+	HRESULT hr;
+	D3D11_MAPPED_SUBRESOURCE vbData, ibData;
+
+	hr = context->Map(vbStaging,
+					  NULL,
+					  D3D11_MAP_READ_WRITE,
+					  NULL,
+					  &vbData);
+	ThrowIfFailed(hr, "Failed to map vertex staging buffer");
+
+	hr = context->Map(ibStaging,
+					  NULL,
+					  readBackIndices ? D3D11_MAP_READ_WRITE : D3D11_MAP_WRITE,
+					  NULL,
+					  &ibData);
+	if (FAILED(hr))
+	{
+		context->Unmap(vbStaging, NULL);
+	}
+	ThrowIfFailed(hr, "Failed to map index staging buffer");
+
+	std::vector<Meshlet> meshlets;
+	Bounds bounds;
+	try
+	{
+		MeshSpan span{
+			reinterpret_cast<Vertex *>(vbData.pData), size.vertexCount,
+			reinterpret_cast<uint32_t *>(ibData.pData), size.indexCount
+		};
+
+		generator(span);
+		meshlets = OptimizeMesh(span, optimization);
+		PackIndices(span.indices, span.indexCount, indexFormat);
+		bounds = ComputeBounds(span.vertices, span.vertexCount);
+	}
+	catch (...)
+	{
+		context->Unmap(vbStaging, NULL);
+		context->Unmap(ibStaging, NULL);
+		throw;
+	}
+
+	context->Unmap(vbStaging, NULL);
+	context->Unmap(ibStaging, NULL);
+
+	auto &mo = GetRenderableMesh(meshId);
+
+	mo.vertexBuffer = m_d3d->CreateBuffer(vbSize,
+										  NULL,
+										  D3D11_BIND_VERTEX_BUFFER,
+										  D3D11_USAGE_DEFAULT,
+										  NULL);
+
+	mo.indexBuffer = m_d3d->CreateBuffer(ibPackedSize,
+										 NULL,
+										 D3D11_BIND_INDEX_BUFFER,
+										 D3D11_USAGE_DEFAULT,
+										 NULL);
+
+	// Packed indices only fill the front of the staging buffer
+	D3D11_BOX ibRange{ 0, 0, 0, ibPackedSize, 1, 1 };
+
+	context->CopyResource(mo.vertexBuffer, vbStaging);
+	context->CopySubresourceRegion(mo.indexBuffer, 0, 0, 0, 0, ibStaging, 0, &ibRange);
+
+	mo.indexFormat = indexFormat;
+	mo.indexCount = size.indexCount;
+	mo.topology = topology;
+	mo.meshlets = std::move(meshlets);
+	mo.bounds = bounds;
 }
 
 void Renderer::AddShader(const std::vector<byte> &vs, const std::vector<byte> &ps)
@@ -218,17 +438,17 @@ void Renderer::AddTexture(const std::vector<byte> &tex)
 
 void Renderer::SetTransforms(uint32_t meshId, uint32_t instanceId, const Transform &transform)
 {
-	auto instanceCount = m_TransformBuffer.count(meshId);
+	auto instanceCount = m_Instances.count(meshId);
 
 	if (instanceCount + 1 < instanceId && instanceId != 0)
 	{
 		return;
 	}
 
-	auto itRange = m_TransformBuffer.equal_range(meshId);
+	auto itRange = m_Instances.equal_range(meshId);
 	auto it = std::next(itRange.first, instanceId);
-	if (itRange.first == m_TransformBuffer.end() ||
-		it == m_TransformBuffer.end())
+	if (itRange.first == m_Instances.end() ||
+		it == m_Instances.end())
 	{
 
 		auto transformBuffer = m_d3d->CreateBuffer(sizeof(Transform),
@@ -237,11 +457,14 @@ void Renderer::SetTransforms(uint32_t meshId, uint32_t instanceId, const Transfo
 												   D3D11_USAGE_DYNAMIC,
 												   D3D11_CPU_ACCESS_WRITE);
 
-		m_TransformBuffer.insert({ meshId, transformBuffer });
+		RenderableInstance instance{ transformBuffer };
+		DirectX::XMStoreFloat4x4(&instance.transform, transform.matrix);
+		m_Instances.insert({ meshId, instance });
 	}
 	else
 	{
-		auto transformBuffer = it->second;
+		auto transformBuffer = it->second.transformBuffer;
+		DirectX::XMStoreFloat4x4(&it->second.transform, transform.matrix);
 
 		auto context = m_d3d->GetContext();
 		HRESULT hr;
@@ -276,6 +499,8 @@ void Learnings::Renderer::SetTopology(uint32_t meshId, D3D11_PRIMITIVE_TOPOLOGY
 
 void Renderer::SetProjection(const Projection &projection)
 {
+	DirectX::XMStoreFloat4x4(&m_Projection, projection.matrix);
+
 	if (!m_ProjectionBuffer)
 	{
 		m_ProjectionBuffer = m_d3d->CreateBuffer(sizeof(Transform),
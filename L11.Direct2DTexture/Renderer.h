@@ -3,26 +3,52 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <functional>
 #include "Direct3D.h"
 #include "Direct2D.h"
+#include "Mesh.h"
+#include "Meshlets.h"
 
 
 namespace Learnings
 {
-	struct Mesh;
-	struct Transform;
-	struct Projection;
-
 	struct RenderableMesh
 	{
 		Direct3d::Buffer vertexBuffer;
 		Direct3d::Buffer indexBuffer;
+		DXGI_FORMAT indexFormat;
 		uint32_t indexCount;
 		uint32_t id;
+		D3D11_PRIMITIVE_TOPOLOGY topology;	// SetTopology rules override it
+
+		// Of the uploaded vertices, in mesh space
+		Bounds bounds;
+
+		// Index ranges culled one by one in Draw, empty draws the whole mesh
+		std::vector<Meshlet> meshlets;
+	};
+
+	struct RenderableInstance
+	{
+		Direct3d::Buffer transformBuffer;
+		DirectX::XMFLOAT4X4 transform;		// CPU copy for culling, as uploaded (transposed)
 	};
 
 	class Renderer
 	{
+	public:
+		typedef std::function<void(const MeshSpan &)> MeshGenerator;
+
+		// Optional passes run on geometry before upload, can be combined
+		enum MeshOptimization
+		{
+			None = 0,
+			VertexCache = 1 << 0,	// reorder triangles for the post-transform cache
+			VertexFetch = 1 << 1,	// reorder vertices by first use, runs after VertexCache
+			Meshlets = 1 << 2,		// split triangle lists into meshlets for per-instance culling, runs between the two
+		};
+		// All passes need triangle lists. Meshes and streamed geometry of other topologies skip them
+
 	public:
 		Renderer(HWND hWnd);
 		~Renderer();
@@ -30,7 +56,9 @@ namespace Learnings
 		void Draw();
 		void Resize();
 
-		void AddGeometry(uint32_t meshId, const Mesh &mesh);
+		void AddGeometry(uint32_t meshId, const Mesh &mesh, uint32_t optimization = None);
+		void AddGeometry(uint32_t meshId, const MeshSize &size, const MeshGenerator &generator,
+						 D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, uint32_t optimization = None);
 		void AddShader(const std::vector<byte> &vs, const std::vector<byte> &ps);
 		void AddTexture(const std::vector<byte> &tex);
 		void SetTransforms(uint32_t meshId, uint32_t instanceId, const Transform &transform);
@@ -40,6 +68,8 @@ namespace Learnings
 		void AddText(const std::wstring &text);
 
 	private:
+		RenderableMesh &GetRenderableMesh(uint32_t meshId);
+
 		void CreateStates();
 		void DeleteStates();
 
@@ -49,10 +79,11 @@ namespace Learnings
 
 		std::vector<RenderableMesh> m_Meshes;
 		std::map<uint32_t, uint32_t> m_MeshIds;
-		std::multimap<uint32_t, Direct3d::Buffer> m_TransformBuffer;
+		std::multimap<uint32_t, RenderableInstance> m_Instances;
 		std::map<uint32_t, D3D11_PRIMITIVE_TOPOLOGY> m_TopologyRules;
 
 		Direct3d::Buffer m_ProjectionBuffer;
+		DirectX::XMFLOAT4X4 m_Projection;		// CPU copy for culling, as uploaded (transposed)
 
 		Direct3d::VertexShader m_VertexShader;
 		Direct3d::PixelShader m_PixelShader;
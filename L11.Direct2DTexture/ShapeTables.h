@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <DirectXMath.h>
+
+#include "Mesh.h"
+
+namespace Learnings
+{
+	// Vertex without the DirectXMath constructors, so tables of it can be constexpr
+	struct UnitVertex
+	{
+		float x, y, z;
+		float u, v;
+	};
+
+	// Fixed primitive baked at compile time, 1 unit across and centered on the origin
+	template <size_t V, size_t I>
+	struct UnitMesh
+	{
+		std::array<UnitVertex, V> vertices;
+		std::array<uint32_t, I> indices;
+
+		constexpr MeshSize Size() const
+		{
+			return{ static_cast<uint32_t>(V), static_cast<uint32_t>(I) };
+		}
+	};
+
+	// Copy a unit table into out as position * scale + offset
+	void WriteUnitMesh(const MeshSpan &out,
+					   const UnitVertex *vertices, uint32_t vertexCount,
+					   const uint32_t *indices, uint32_t indexCount,
+					   const DirectX::XMFLOAT3 &scale, const DirectX::XMFLOAT3 &offset);
+
+	template <size_t V, size_t I>
+	void WriteUnitMesh(const MeshSpan &out, const UnitMesh<V, I> &mesh,
+					   const DirectX::XMFLOAT3 &scale, const DirectX::XMFLOAT3 &offset)
+	{
+		WriteUnitMesh(out,
+					  mesh.vertices.data(), static_cast<uint32_t>(V),
+					  mesh.indices.data(), static_cast<uint32_t>(I),
+					  scale, offset);
+	}
+
+	// base = 1, height = 1, tip over the center
+	constexpr UnitMesh<3, 3> C_UnitTriangle{ {
+		{
+			{ 0.0f, 0.5f, 0.0f, 0.5f, 0.0f },
+			{ 0.5f, -0.5f, 0.0f, 1.0f, 1.0f },
+			{ -0.5f, -0.5f, 0.0f, 0.0f, 1.0f },
+		} }, {
+		{ 0, 1, 2 }
+	} };
+
+	// length = 1, width = 1
+	constexpr UnitMesh<4, 6> C_UnitRectangle{ {
+		{
+			{ -0.5f, +0.5f, 0.0f, 0.0f, 0.0f },
+			{ +0.5f, +0.5f, 0.0f, 1.0f, 0.0f },
+			{ +0.5f, -0.5f, 0.0f, 1.0f, 1.0f },
+			{ -0.5f, -0.5f, 0.0f, 0.0f, 1.0f },
+		} }, {
+		{
+			0, 1, 2,
+			0, 2, 3
+		}
+	} };
+
+	// length = 1, width = 1, height = 1
+	constexpr UnitMesh<24, 36> C_UnitBox{ {
+		{
+			// Front
+			{ -0.5f, -0.5f, +0.5f, 0.0f, 0.0f },
+			{ +0.5f, -0.5f, +0.5f, 1.0f, 0.0f },
+			{ +0.5f, +0.5f, +0.5f, 1.0f, 1.0f },
+			{ -0.5f, +0.5f, +0.5f, 0.0f, 1.0f },
+
+			// Bottom
+			{ -0.5f, -0.5f, -0.5f, 0.0f, 0.0f },
+			{ +0.5f, -0.5f, -0.5f, 1.0f, 0.0f },
+			{ +0.5f, -0.5f, +0.5f, 1.0f, 1.0f },
+			{ -0.5f, -0.5f, +0.5f, 0.0f, 1.0f },
+
+			// Right
+			{ +0.5f, -0.5f, -0.5f, 0.0f, 0.0f },
+			{ +0.5f, +0.5f, -0.5f, 1.0f, 0.0f },
+			{ +0.5f, +0.5f, +0.5f, 1.0f, 1.0f },
+			{ +0.5f, -0.5f, +0.5f, 0.0f, 1.0f },
+
+			// Left
+			{ -0.5f, -0.5f, -0.5f, 0.0f, 0.0f },
+			{ -0.5f, -0.5f, +0.5f, 1.0f, 0.0f },
+			{ -0.5f, +0.5f, +0.5f, 1.0f, 1.0f },
+			{ -0.5f, +0.5f, -0.5f, 0.0f, 1.0f },
+
+			// Back
+			{ -0.5f, -0.5f, -0.5f, 0.0f, 0.0f },
+			{ -0.5f, +0.5f, -0.5f, 1.0f, 0.0f },
+			{ +0.5f, +0.5f, -0.5f, 1.0f, 1.0f },
+			{ +0.5f, -0.5f, -0.5f, 0.0f, 1.0f },
+
+			// Top
+			{ -0.5f, +0.5f, -0.5f, 0.0f, 0.0f },
+			{ -0.5f, +0.5f, +0.5f, 1.0f, 0.0f },
+			{ +0.5f, +0.5f, +0.5f, 1.0f, 1.0f },
+			{ +0.5f, +0.5f, -0.5f, 0.0f, 1.0f },
+		} }, {
+		{
+			// Front
+			0, 1, 2, 0, 2, 3,
+			// Bottom
+			4, 5, 6, 4, 6, 7,
+			// Right
+			8, 9, 10, 8, 10, 11,
+			// Left
+			12, 13, 14, 12, 14, 15,
+			// Back
+			16, 17, 18, 16, 18, 19,
+			// Top
+			20, 21, 22, 20, 22, 23,
+		}
+	} };
+
+	// radius = 1, tip up, base ring at cos(120) below the origin.
+	// Tip and first base point are repeated for the UV map |/\/\/|
+	constexpr UnitMesh<6, 12> C_UnitTetrahedron{ {
+		{
+			{ 0.0f, 1.0f, 0.0f, 0.0f / 6.0f, 1.0f },
+			{ 1.0f, -0.5f, 0.0f, 1.0f / 6.0f, 0.0f },
+			{ -0.5f, -0.5f, 0.866025404f, 2.0f / 6.0f, 1.0f },
+			{ -0.5f, -0.5f, -0.866025404f, 3.0f / 6.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 4.0f / 6.0f, 1.0f },
+			{ 1.0f, -0.5f, 0.0f, 5.0f / 6.0f, 0.0f },
+		} }, {
+		{
+			0, 2, 1,
+			1, 2, 3,
+			2, 4, 3,
+			3, 4, 5
+		}
+	} };
+
+	// radius = 1
+	constexpr UnitMesh<6, 24> C_UnitOctahedron{ {
+		{
+			{ 1.0f, 0.0f, 0.0f, 0.0f, 0.5f },
+			{ 0.0f, 1.0f, 0.0f, 0.5f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.33f, 0.5f },
+			{ -1.0f, 0.0f, 0.0f, 0.66f, 0.5f },
+			{ 0.0f, -1.0f, 0.0f, 0.5f, 1.0f },
+			{ 0.0f, 0.0f, -1.0f, 1.0f, 0.5f },
+		} }, {
+		{
+			// Top
+			0, 1, 2,
+			2, 1, 3,
+			3, 1, 5,
+			5, 1, 0,
+			// Bottom
+			2, 4, 0,
+			3, 4, 2,
+			5, 4, 3,
+			0, 4, 5
+		}
+	} };
+}
@@ -0,0 +1,427 @@
+#include <cmath>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "Terrain.h"
+
+#include "BasicShapes.h"
+#include "Parallel.h"
+
+using namespace Learnings;
+namespace Math = DirectX;
+
+#pragma region Tiles
+size_t TerrainKey::Hash() const
+{
+	// FNV-1a over the three fields
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](uint32_t value)
+	{
+		hash = (hash ^ value) * 1099511628211ull;
+	};
+
+	mix(static_cast<uint32_t>(x));
+	mix(static_cast<uint32_t>(z));
+	mix(lod);
+
+	return static_cast<size_t>(hash);
+}
+
+TerrainKey TerrainKey::Parent() const
+{
+	// Rounds toward negative infinity, so tiles left of and below the origin find their parent too
+	auto half = [](int32_t v) { return (v < 0) ? (v - 1) / 2 : v / 2; };
+
+	return{ half(x), half(z), lod + 1 };
+}
+
+float Learnings::TileWorldSize(const TerrainSettings &settings, uint32_t lod)
+{
+	return std::ldexp(settings.tileSize, static_cast<int>(lod));
+}
+
+MeshSize Learnings::TerrainTileSize(const TerrainSettings &settings)
+{
+	MeshSize size = GridSize(settings.tileCells, PrimitiveMode::TriangleList);
+
+	// A lowered copy of the 4 * tileCells border vertices, and a quad from each border edge down to it
+	if (settings.skirtDepth > 0.0f)
+	{
+		size.vertexCount += 4u * settings.tileCells;
+		size.indexCount += 24u * settings.tileCells;
+	}
+
+	return size;
+}
+
+// Lifts vertices to the height field, four per call
+static void ApplyHeight(Vertex *vertices, uint32_t count, const HeightFunction &height)
+{
+	for (uint32_t i = 0; i < count; i += 4)
+	{
+		const Vertex &v0 = vertices[i];
+		const Vertex &v1 = vertices[std::min(i + 1, count - 1)];
+		const Vertex &v2 = vertices[std::min(i + 2, count - 1)];
+		const Vertex &v3 = vertices[std::min(i + 3, count - 1)];
+
+		Math::XMFLOAT4 y;
+		Math::XMStoreFloat4(&y, height(Math::XMVectorSet(v0.position.x, v1.position.x, v2.position.x, v3.position.x),
+									   Math::XMVectorSet(v0.position.z, v1.position.z, v2.position.z, v3.position.z)));
+
+		const float lanes[4] = { y.x, y.y, y.z, y.w };
+		for (uint32_t lane = 0; lane < 4 && i + lane < count; lane++)
+		{
+			vertices[i + lane].position.y = lanes[lane];
+		}
+	}
+}
+
+void Learnings::TerrainTile(const MeshSpan &out, const TerrainSettings &settings, const HeightFunction &height, const TerrainKey &key)
+{
+	MeshSize size = TerrainTileSize(settings);
+	if (out.vertexCount < size.vertexCount || out.indexCount < size.indexCount)
+	{
+		throw std::length_error("Mesh span is too small for shape");
+	}
+
+	// Grid lays out the lattice and its triangles, row j column i is vertex j * (n + 1) + i
+	uint32_t n = settings.tileCells;
+	uint32_t rowLength = n + 1u;
+	MeshSize gridSize = GridSize(settings.tileCells, PrimitiveMode::TriangleList);
+	Grid({ out.vertices, gridSize.vertexCount, out.indices, gridSize.indexCount }, 1.0f, settings.tileCells, 1, PrimitiveMode::TriangleList);
+
+	// Place it from world lattice coordinates rather than offsetting Grid's, so neighbours round the same way
+	float cellSize = (n > 0) ? TileWorldSize(settings, key.lod) / n : 0.0f;
+	float uvScale = 1.0f / settings.tileSize;
+	int64_t baseX = static_cast<int64_t>(key.x) * n;
+	int64_t baseZ = static_cast<int64_t>(key.z) * n;
+
+	for (uint32_t j = 0; j < rowLength; j++)
+	{
+		float z = static_cast<float>(baseZ + j) * cellSize;
+		Vertex *vtx = out.vertices + j * rowLength;
+		for (uint32_t i = 0; i < rowLength; i++)
+		{
+			float x = static_cast<float>(baseX + i) * cellSize;
+			vtx[i] = { { x, 0.0f, z }, { x * uvScale, z * uvScale } };
+		}
+	}
+
+	ApplyHeight(out.vertices, gridSize.vertexCount, height);
+
+	if (size.vertexCount == gridSize.vertexCount)
+	{
+		return;
+	}
+
+	// Border walked counterclockwise seen from above, so each skirt quad faces out of the tile
+	uint32_t ringLength = 4u * n;
+	auto ring = [&](uint32_t k) -> uint32_t
+	{
+		uint32_t t = k % n;
+		switch (k / n)
+		{
+			case 0: return t;								// -Z edge, toward +X
+			case 1: return t * rowLength + n;				// +X edge, toward +Z
+			case 2: return n * rowLength + (n - t);			// +Z edge, toward -X
+			default: return (n - t) * rowLength;			// -X edge, toward -Z
+		}
+	};
+
+	uint32_t skirtBase = gridSize.vertexCount;
+	uint32_t *idx = out.indices + gridSize.indexCount;
+	for (uint32_t k = 0; k < ringLength; k++)
+	{
+		Vertex skirt = out.vertices[ring(k)];
+		skirt.position.y -= settings.skirtDepth;
+		out.vertices[skirtBase + k] = skirt;
+
+		uint32_t a = ring(k), b = ring((k + 1) % ringLength);
+		uint32_t aLow = skirtBase + k, bLow = skirtBase + (k + 1) % ringLength;
+		idx[0] = a; idx[1] = b; idx[2] = aLow;
+		idx[3] = b; idx[4] = bLow; idx[5] = aLow;
+		idx += 6;
+	}
+}
+
+Mesh Learnings::TerrainTile(const TerrainSettings &settings, const HeightFunction &height, const TerrainKey &key)
+{
+	Mesh tile;
+	TerrainTile(tile.Resize(TerrainTileSize(settings)), settings, height, key);
+	tile.UpdateBounds();
+
+	return tile;
+}
+
+// Distance from the camera to the tile's square at height 0
+static float TileDistance(const TerrainSettings &settings, const TerrainKey &key, const Math::XMFLOAT3 &camera)
+{
+	float size = TileWorldSize(settings, key.lod);
+	float x0 = key.x * size, z0 = key.z * size;
+
+	float dx = std::max(0.0f, std::max(x0 - camera.x, camera.x - (x0 + size)));
+	float dz = std::max(0.0f, std::max(z0 - camera.z, camera.z - (z0 + size)));
+
+	return std::sqrt(dx * dx + camera.y * camera.y + dz * dz);
+}
+
+std::vector<TerrainKey> Learnings::SelectTerrainTiles(const TerrainSettings &settings, const Math::XMFLOAT3 &camera)
+{
+	if (settings.lodCount == 0 || settings.lodCount > 30 || settings.tileSize <= 0.0f)
+	{
+		throw std::runtime_error("Terrain needs 1 to 30 lods and a positive tile size");
+	}
+
+	std::vector<TerrainKey> tiles;
+
+	std::function<void(const TerrainKey &)> refine = [&](const TerrainKey &key)
+	{
+		float distance = TileDistance(settings, key, camera);
+		if (distance > settings.viewDistance)
+		{
+			return;
+		}
+
+		if (key.lod == 0 || distance >= settings.splitDistance * TileWorldSize(settings, key.lod))
+		{
+			tiles.push_back(key);
+			return;
+		}
+
+		for (int32_t dz = 0; dz < 2; dz++)
+		{
+			for (int32_t dx = 0; dx < 2; dx++)
+			{
+				refine({ key.x * 2 + dx, key.z * 2 + dz, key.lod - 1 });
+			}
+		}
+	};
+
+	uint32_t top = settings.lodCount - 1;
+	float topSize = TileWorldSize(settings, top);
+	int32_t x0 = static_cast<int32_t>(std::floor((camera.x - settings.viewDistance) / topSize));
+	int32_t x1 = static_cast<int32_t>(std::floor((camera.x + settings.viewDistance) / topSize));
+	int32_t z0 = static_cast<int32_t>(std::floor((camera.z - settings.viewDistance) / topSize));
+	int32_t z1 = static_cast<int32_t>(std::floor((camera.z + settings.viewDistance) / topSize));
+
+	for (int32_t z = z0; z <= z1; z++)
+	{
+		for (int32_t x = x0; x <= x1; x++)
+		{
+			refine({ x, z, top });
+		}
+	}
+
+	std::stable_sort(tiles.begin(), tiles.end(), [&](const TerrainKey &a, const TerrainKey &b)
+	{
+		return TileDistance(settings, a, camera) < TileDistance(settings, b, camera);
+	});
+
+	return tiles;
+}
+#pragma endregion
+
+#pragma region Streamer
+TerrainStreamer::TerrainStreamer(const TerrainSettings &settings, const HeightFunction &height) :
+	m_Settings(settings),
+	m_Height(height)
+{
+	uint32_t workerCount = ThreadCount(settings.workerCount);
+	m_Workers.reserve(workerCount);
+	for (uint32_t t = 0; t < workerCount; t++)
+	{
+		m_Workers.emplace_back([this]() { Work(); });
+	}
+}
+
+TerrainStreamer::~TerrainStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Stop = true;
+	}
+	m_Wake.notify_all();
+
+	for (auto &worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+void TerrainStreamer::Update(const Math::XMFLOAT3 &camera)
+{
+	auto wanted = SelectTerrainTiles(m_Settings, camera);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+
+		// The failed tile is not resident, so the next Update queues it again
+		if (m_Error)
+		{
+			std::exception_ptr error = m_Error;
+			m_Error = nullptr;
+			std::rethrow_exception(error);
+		}
+
+		m_Frame++;
+
+		// Queue what is missing, nearest first, anything queued for an earlier camera is dropped
+		m_Queue.clear();
+		std::unordered_set<TerrainKey, TerrainKeyHash> standIns;
+		for (auto &key : wanted)
+		{
+			if (m_Resident.count(key) != 0)
+			{
+				continue;
+			}
+
+			if (m_InFlight.count(key) == 0)
+			{
+				m_Queue.push_back(key);
+			}
+
+			for (TerrainKey ancestor = key; ancestor.lod + 1 < m_Settings.lodCount;)
+			{
+				ancestor = ancestor.Parent();
+				if (m_Resident.count(ancestor) != 0)
+				{
+					standIns.insert(ancestor);
+					break;
+				}
+			}
+		}
+
+		// A tile is drawn through its outermost stand-in ancestor if it has one, each stand-in once
+		std::unordered_set<TerrainKey, TerrainKeyHash> drawn;
+		m_Tiles.clear();
+		for (auto &key : wanted)
+		{
+			TerrainKey draw = key;
+			for (TerrainKey ancestor = key; ancestor.lod + 1 < m_Settings.lodCount;)
+			{
+				ancestor = ancestor.Parent();
+				if (standIns.count(ancestor) != 0)
+				{
+					draw = ancestor;
+				}
+			}
+
+			auto resident = m_Resident.find(draw);
+			if (resident != m_Resident.end() && drawn.insert(draw).second)
+			{
+				Touch(resident->second);
+				m_Tiles.push_back({ draw, resident->second.mesh });
+			}
+		}
+
+		Evict();
+	}
+
+	m_Wake.notify_all();
+}
+
+void TerrainStreamer::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+	m_Idle.wait(lock, [this]() { return m_Queue.empty() && m_InFlight.empty(); });
+}
+
+size_t TerrainStreamer::ResidentBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return m_ResidentBytes;
+}
+
+uint32_t TerrainStreamer::ResidentCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return static_cast<uint32_t>(m_Resident.size());
+}
+
+void TerrainStreamer::Work()
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+	for (;;)
+	{
+		m_Wake.wait(lock, [this]() { return m_Stop || !m_Queue.empty(); });
+		if (m_Stop)
+		{
+			return;
+		}
+
+		TerrainKey key = m_Queue.front();
+		m_Queue.pop_front();
+		m_InFlight.insert(key);
+
+		// A throwing height function must not take the worker down or leave the key in flight,
+		// Flush would wait for it forever
+		MeshPtr mesh;
+		std::exception_ptr error;
+		lock.unlock();
+		try
+		{
+			mesh = std::make_shared<const Mesh>(TerrainTile(m_Settings, m_Height, key));
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+		lock.lock();
+
+		m_InFlight.erase(key);
+
+		if (error)
+		{
+			if (!m_Error)
+			{
+				m_Error = error;
+			}
+
+			if (m_Queue.empty() && m_InFlight.empty())
+			{
+				m_Idle.notify_all();
+			}
+			continue;
+		}
+
+		// Counts as used by the current Update, so it lives at least until the next one draws it
+		size_t bytes = mesh->vertices.size() * sizeof(Vertex) + mesh->indices.size() * sizeof(uint32_t);
+		m_Lru.push_front(key);
+		m_Resident[key] = { mesh, bytes, m_Frame, m_Lru.begin() };
+		m_ResidentBytes += bytes;
+		m_Generated++;
+
+		Evict();
+
+		if (m_Queue.empty() && m_InFlight.empty())
+		{
+			m_Idle.notify_all();
+		}
+	}
+}
+
+void TerrainStreamer::Touch(Resident &resident)
+{
+	resident.lastUsed = m_Frame;
+	m_Lru.splice(m_Lru.begin(), m_Lru, resident.lru);
+}
+
+void TerrainStreamer::Evict()
+{
+	// Tiles used this Update are all at the front, so stop at the first one
+	while (m_ResidentBytes > m_Settings.memoryBudget && !m_Lru.empty())
+	{
+		auto resident = m_Resident.find(m_Lru.back());
+		if (resident->second.lastUsed == m_Frame)
+		{
+			break;
+		}
+
+		m_ResidentBytes -= resident->second.bytes;
+		m_Resident.erase(resident);
+		m_Lru.pop_back();
+		m_Evicted++;
+	}
+}
+#pragma endregion
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <list>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <exception>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
+#include <DirectXMath.h>
+
+#include "Mesh.h"
+
+namespace Learnings
+{
+	// Terrain height at four XZ points at once, one per lane
+	typedef std::function<DirectX::XMVECTOR(DirectX::FXMVECTOR x, DirectX::FXMVECTOR z)> HeightFunction;
+
+	// Tile x, z at a level of detail, tile (x, z, lod) covers
+	// [x, x + 1) * TileWorldSize(lod) by [z, z + 1) * TileWorldSize(lod) and has four children at lod - 1
+	struct TerrainKey
+	{
+		int32_t x;
+		int32_t z;
+		uint32_t lod;
+
+		bool operator==(const TerrainKey &key) const { return x == key.x && z == key.z && lod == key.lod; }
+		size_t Hash() const;
+
+		TerrainKey Parent() const;
+	};
+
+	struct TerrainKeyHash
+	{
+		size_t operator()(const TerrainKey &key) const { return key.Hash(); }
+	};
+
+	struct TerrainSettings
+	{
+		float tileSize;			// world size of a lod 0 tile, each lod doubles it
+		uint16_t tileCells;		// cells along a tile edge, the same at every lod
+		uint32_t lodCount;
+		float splitDistance;	// a tile splits into its children closer than this many of its own widths
+		float viewDistance;		// tiles further than this from the camera are not wanted
+		float skirtDepth;		// skirts hang this far below the tile edges to hide cracks between lods, 0 for none
+		size_t memoryBudget;	// bytes of tile geometry kept resident
+		uint32_t workerCount;	// background generator threads, 0 is one per hardware thread
+	};
+
+	float TileWorldSize(const TerrainSettings &settings, uint32_t lod);
+
+	// One tile is a Grid triangle list moved to the tile and lifted by height, then a skirt of
+	// quads hanging down from its border. Positions come from world lattice coordinates,
+	// so tiles of the same lod meet bit for bit. Texture coordinates repeat once per lod 0 tile
+	MeshSize TerrainTileSize(const TerrainSettings &settings);
+	void TerrainTile(const MeshSpan &out, const TerrainSettings &settings, const HeightFunction &height, const TerrainKey &key);
+	Mesh TerrainTile(const TerrainSettings &settings, const HeightFunction &height, const TerrainKey &key);
+
+	// The wanted tiles for a camera, a quadtree walked down from the coarsest lod, nearest first
+	std::vector<TerrainKey> SelectTerrainTiles(const TerrainSettings &settings, const DirectX::XMFLOAT3 &camera);
+
+	// Keeps the tiles around a moving camera resident. Update selects the wanted tiles and queues the
+	// missing ones, nearest first, for the worker threads. Requests the camera has moved away from are dropped.
+	// Resident tiles are kept in least recently used order and evicted once memoryBudget is passed,
+	// but never one drawn in the last Update, so a budget below one view's worth is overrun instead of thrashing.
+	// height is called from the worker threads, several at once. An exception it throws
+	// is rethrown by the next Update, the tile it was generating is left out until then
+	class TerrainStreamer
+	{
+	public:
+		typedef std::shared_ptr<const Mesh> MeshPtr;
+
+		struct Tile
+		{
+			TerrainKey key;
+			MeshPtr mesh;
+		};
+
+		TerrainStreamer(const TerrainSettings &settings, const HeightFunction &height);
+		~TerrainStreamer();
+
+		TerrainStreamer(const TerrainStreamer &) = delete;
+		TerrainStreamer &operator=(const TerrainStreamer &) = delete;
+
+		void Update(const DirectX::XMFLOAT3 &camera);
+
+		// What to draw after the last Update. A wanted tile still being generated is stood in for by its
+		// nearest resident ancestor, which replaces all of its wanted descendants, so the ground has no holes
+		// and no overlaps once any covering tile is resident
+		const std::vector<Tile> &Tiles() const { return m_Tiles; }
+
+		// Block until every queued tile is generated, the next Update draws them
+		void Flush();
+
+		size_t ResidentBytes() const;
+		uint32_t ResidentCount() const;
+		uint32_t GenerateCount() const { return m_Generated; }
+		uint32_t EvictCount() const { return m_Evicted; }
+
+	private:
+		struct Resident
+		{
+			MeshPtr mesh;
+			size_t bytes;
+			uint64_t lastUsed;					// Update that last drew it
+			std::list<TerrainKey>::iterator lru;
+		};
+
+		void Work();
+		void Touch(Resident &resident);
+		void Evict();
+
+		TerrainSettings m_Settings;
+		HeightFunction m_Height;
+
+		mutable std::mutex m_Lock;
+		std::condition_variable m_Wake;
+		std::condition_variable m_Idle;
+		bool m_Stop = false;
+
+		std::unordered_map<TerrainKey, Resident, TerrainKeyHash> m_Resident;
+		std::list<TerrainKey> m_Lru;			// most recently used first
+		std::deque<TerrainKey> m_Queue;
+		std::unordered_set<TerrainKey, TerrainKeyHash> m_InFlight;
+		size_t m_ResidentBytes = 0;
+		std::exception_ptr m_Error;				// first failed generation since the last Update
+		uint64_t m_Frame = 0;
+
+		std::vector<Tile> m_Tiles;
+		std::vector<std::thread> m_Workers;
+
+		uint32_t m_Generated = 0;
+		uint32_t m_Evicted = 0;
+	};
+}
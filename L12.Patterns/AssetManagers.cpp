@@ -47,6 +47,14 @@ void ShaderManager::CreateInputLayout(const Data &vsf, uint32_t vertexId)
 		{
 			il = m_GfxDev->CreateInputLayout(VertexPositionTexture::ElementsDesc, vsf);
 		}
+		else if (vertexId == VertexPositionTextureUnorm16::Id)
+		{
+			il = m_GfxDev->CreateInputLayout(VertexPositionTextureUnorm16::ElementsDesc, vsf);
+		}
+		else if (vertexId == VertexPositionTextureHalf::Id)
+		{
+			il = m_GfxDev->CreateInputLayout(VertexPositionTextureHalf::ElementsDesc, vsf);
+		}
 
 		if (il)
 		{
@@ -58,11 +66,20 @@ void ShaderManager::CreateInputLayout(const Data &vsf, uint32_t vertexId)
 	{
 		ilId = it->second;
 
+		bool isCorrect = true;
 		if (vertexId == VertexPositionTexture::Id)
 		{
-			auto isCorrect = m_GfxDev->CheckInputLayout(VertexPositionTexture::ElementsDesc, vsf);
-			ThrowIfFailed(isCorrect, "Input layout doesn't match shader");
+			isCorrect = m_GfxDev->CheckInputLayout(VertexPositionTexture::ElementsDesc, vsf);
+		}
+		else if (vertexId == VertexPositionTextureUnorm16::Id)
+		{
+			isCorrect = m_GfxDev->CheckInputLayout(VertexPositionTextureUnorm16::ElementsDesc, vsf);
+		}
+		else if (vertexId == VertexPositionTextureHalf::Id)
+		{
+			isCorrect = m_GfxDev->CheckInputLayout(VertexPositionTextureHalf::ElementsDesc, vsf);
 		}
+		ThrowIfFailed(isCorrect, "Input layout doesn't match shader");
 	}
 
 	m_Shader_IL.insert({ m_NextKey, ilId });
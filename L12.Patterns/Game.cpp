@@ -126,17 +126,24 @@ void Game::Load()
 			}
 		};
 
+#if defined(DEBUG) || defined(_DEBUG)
+		// Which packed vertex format would suit this mesh, see Pack
+		OutputDebugStringA(QuantizationReport(mesh).c_str());
+#endif
+
 		vb = m_GfxDev->CreateBuffer(mesh.vertices.data(),
 									mesh.VertexListSize(),
 									D3D11_BIND_VERTEX_BUFFER,
 									D3D11_USAGE_DEFAULT,
 									NULL);
-		ib = m_GfxDev->CreateBuffer(mesh.indices.data(),
+		auto indexData = mesh.IndexData();
+		ib = m_GfxDev->CreateBuffer(indexData.data(),
 									mesh.IndexListSize(),
 									D3D11_BIND_INDEX_BUFFER,
 									D3D11_USAGE_DEFAULT,
 									NULL);
 		ic = (uint32_t)mesh.indices.size();
+		ifmt = mesh.IndexFormat();
 	}
 
 	m_Window->Show();
@@ -160,7 +167,7 @@ void Game::Update()
 	m_RT->SetShaderResource({
 		std::make_tuple(RenderTarget::Stage::Pixel, srv, 0)
 	});
-	m_RT->SetMeshData(vb, VertexPositionTexture::Size, ib);
+	m_RT->SetMeshData(vb, VertexPositionTexture::Size, ib, ifmt);
 	m_RT->SetStates(nullptr, nullptr, nullptr, nullptr);
 	//m_RT->SetView();	// if we didn't do it earlier
 }
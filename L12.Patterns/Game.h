@@ -37,6 +37,7 @@ namespace Learnings
 
 		GraphicsDevice::Buffer vb, ib;
 		uint32_t ic;
+		DXGI_FORMAT ifmt;
 
 	private:
 		std::unique_ptr<Window> m_Window;
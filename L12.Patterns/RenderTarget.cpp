@@ -144,12 +144,12 @@ void RenderTarget::SetShaderResource(const ShaderResourceList &resources)
 
 }
 
-void RenderTarget::SetMeshData(GraphicsDevice::Buffer vb, uint32_t vertexSize, GraphicsDevice::Buffer ib)
+void RenderTarget::SetMeshData(GraphicsDevice::Buffer vb, uint32_t vertexSize, GraphicsDevice::Buffer ib, DXGI_FORMAT indexFormat)
 {
 	UINT vertexOffset = 0, indexOffset = 0;
 
 	m_Context->IASetVertexBuffers(0, 1, &(vb.p), &vertexSize, &vertexOffset);
-	m_Context->IASetIndexBuffer(ib, DXGI_FORMAT_R32_UINT, indexOffset);
+	m_Context->IASetIndexBuffer(ib, indexFormat, indexOffset);
 }
 
 void RenderTarget::Draw(uint32_t indexCount, uint32_t indexStart, uint32_t vertexStart)
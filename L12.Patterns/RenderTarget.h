@@ -41,7 +41,7 @@ namespace Learnings
 		void SetStates(GraphicsDevice::BlendState bs, GraphicsDevice::DepthStencilState ds, GraphicsDevice::RasterizerState rs, GraphicsDevice::SamplerState ss);
 		void SetConstantBuffers(const ConstantBufferList &buffers);
 		void SetShaderResource(const ShaderResourceList &resources);
-		void SetMeshData(GraphicsDevice::Buffer vb, uint32_t vertexSize, GraphicsDevice::Buffer ib);
+		void SetMeshData(GraphicsDevice::Buffer vb, uint32_t vertexSize, GraphicsDevice::Buffer ib, DXGI_FORMAT indexFormat);
 
 		void Draw(uint32_t indexCount, uint32_t indexStart, uint32_t vertexStart);
 
@@ -1,6 +1,16 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <intrin.h>
+#include <DirectXPackedVector.h>
+
 #include "Vertex.h"
 
 using namespace Learnings;
+using namespace DirectX;
+using namespace DirectX::PackedVector;
 
 // VertexPositionTexture
 const std::array<D3D11_INPUT_ELEMENT_DESC, VertexPositionTexture::C_VertexElementCount> VertexPositionTexture::ElementsDesc{ {
@@ -11,6 +21,26 @@ const std::array<D3D11_INPUT_ELEMENT_DESC, VertexPositionTexture::C_VertexElemen
 const uint32_t VertexPositionTexture::Size = sizeof(VertexPositionTexture);
 const uint32_t VertexPositionTexture::Id = reinterpret_cast<uint32_t>(&VertexPositionTexture::ElementsDesc);
 
+// VertexPositionTextureUnorm16
+const std::array<D3D11_INPUT_ELEMENT_DESC, VertexPositionTextureUnorm16::C_VertexElementCount> VertexPositionTextureUnorm16::ElementsDesc{ {
+	{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+} };
+
+const uint32_t VertexPositionTextureUnorm16::Size = sizeof(VertexPositionTextureUnorm16);
+const uint32_t VertexPositionTextureUnorm16::Id = reinterpret_cast<uint32_t>(&VertexPositionTextureUnorm16::ElementsDesc);
+
+// VertexPositionTextureHalf
+const std::array<D3D11_INPUT_ELEMENT_DESC, VertexPositionTextureHalf::C_VertexElementCount> VertexPositionTextureHalf::ElementsDesc{ {
+	{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+} };
+
+const uint32_t VertexPositionTextureHalf::Size = sizeof(VertexPositionTextureHalf);
+const uint32_t VertexPositionTextureHalf::Id = reinterpret_cast<uint32_t>(&VertexPositionTextureHalf::ElementsDesc);
+
+static_assert(sizeof(VertexPositionTextureUnorm16) == 12 && sizeof(VertexPositionTextureHalf) == 12, "packed vertices must stay 12 bytes");
+
 
 uint32_t Mesh::VertexListSize() const
 {
@@ -19,10 +49,487 @@ uint32_t Mesh::VertexListSize() const
 
 uint32_t Mesh::IndexListSize() const
 {
-	return static_cast<uint32_t>(indices.size()) * sizeof(uint32_t);
+	uint32_t indexSize = (IndexFormat() == DXGI_FORMAT_R16_UINT) ? sizeof(uint16_t) : sizeof(uint32_t);
+	return static_cast<uint32_t>(indices.size()) * indexSize;
+}
+
+DXGI_FORMAT Mesh::IndexFormat() const
+{
+	return (vertices.size() <= 0xFFFF) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+std::vector<uint8_t> Mesh::IndexData() const
+{
+	std::vector<uint8_t> data(IndexListSize());
+
+	if (IndexFormat() == DXGI_FORMAT_R16_UINT)
+	{
+		uint16_t *packed = reinterpret_cast<uint16_t *>(data.data());
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			packed[i] = static_cast<uint16_t>(indices[i]);
+		}
+	}
+	else if (!indices.empty())
+	{
+		std::memcpy(data.data(), indices.data(), data.size());
+	}
+
+	return data;
 }
 
 uint32_t Mesh::VertexStride()
 {
 	return VertexPositionTexture::Size;
-}
\ No newline at end of file
+}
+
+#pragma region Packed Mesh
+// Encode and decode kernels, four vertices per iteration. A block of vertices is transposed
+// into one register per component, converted side by side and interleaved back, so the
+// 16 bit conversions run four vertices wide instead of one.
+// Unorm16 needs only SSE2. Halves use F16C when the CPU has it, else DirectXMath one vertex at a time
+
+// Runs kernel on blocks of four, the last partial block through zero padded copies
+template <typename In, typename Out, typename Kernel>
+static void ForEachBlock(const In *in, uint32_t count, Out *out, Kernel kernel)
+{
+	uint32_t full = count & ~3u;
+	for (uint32_t i = 0; i < full; i += 4)
+	{
+		kernel(in + i, out + i);
+	}
+
+	if (full < count)
+	{
+		In padIn[4] = {};
+		Out padOut[4] = {};
+		for (uint32_t i = full; i < count; i++)
+		{
+			padIn[i - full] = in[i];
+		}
+
+		kernel(padIn, padOut);
+
+		for (uint32_t i = full; i < count; i++)
+		{
+			out[i] = padOut[i - full];
+		}
+	}
+}
+
+#if defined(_XM_SSE_INTRINSICS_)
+// Four vertices, one register per component
+struct FloatBlock
+{
+	__m128 x, y, z, u, v;
+};
+
+// Four packed vertices, two components per register, four 16 bit values each
+struct Packed16Block
+{
+	__m128i xy, zw, uv;
+};
+
+static FloatBlock LoadFloats(const VertexPositionTexture *in)
+{
+	// x y z u of one vertex per load, then v on its own
+	__m128 r0 = _mm_loadu_ps(&in[0].position.x);
+	__m128 r1 = _mm_loadu_ps(&in[1].position.x);
+	__m128 r2 = _mm_loadu_ps(&in[2].position.x);
+	__m128 r3 = _mm_loadu_ps(&in[3].position.x);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	return{ r0, r1, r2, r3, _mm_setr_ps(in[0].texCoord.y, in[1].texCoord.y, in[2].texCoord.y, in[3].texCoord.y) };
+}
+
+static void StoreFloats(FloatBlock block, VertexPositionTexture *out)
+{
+	_MM_TRANSPOSE4_PS(block.x, block.y, block.z, block.u);
+	const __m128 rows[4] = { block.x, block.y, block.z, block.u };
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		// Writes x y z u, v goes in after it
+		_mm_storeu_ps(&out[i].position.x, rows[i]);
+		_mm_store_ss(&out[i].texCoord.y, block.v);
+		block.v = _mm_shuffle_ps(block.v, block.v, _MM_SHUFFLE(0, 3, 2, 1));
+	}
+}
+
+// 48 bytes of PackedVertex as three registers, 32 bit lanes:
+// x0y0 z0w0 uv0 x1y1 | z1w1 uv1 x2y2 z2w2 | uv2 x3y3 z3w3 uv3
+static void StorePacked(const Packed16Block &block, PackedVertex *out)
+{
+	// x0 y0 z0 w0 x1 y1 z1 w1 and the same for vertices 2 and 3
+	__m128i xz = _mm_unpacklo_epi16(block.xy, block.zw);
+	__m128i yw = _mm_unpackhi_epi16(block.xy, block.zw);
+	__m128i p01 = _mm_unpacklo_epi16(xz, yw);
+	__m128i p23 = _mm_unpackhi_epi16(xz, yw);
+
+	// u0 v0 u1 v1 u2 v2 u3 v3
+	__m128i uv = _mm_unpacklo_epi16(block.uv, _mm_srli_si128(block.uv, 8));
+
+	__m128i t = _mm_unpacklo_epi32(uv, _mm_srli_si128(p01, 8));				// uv0 x1y1 uv1 z1w1
+	__m128i s = _mm_unpackhi_epi32(uv, p23);								// uv2 x3y3 uv3 z3w3
+
+	__m128i *dst = reinterpret_cast<__m128i *>(out);
+	_mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(p01, t));
+	_mm_storeu_si128(dst + 1, _mm_unpacklo_epi64(_mm_shuffle_epi32(t, _MM_SHUFFLE(0, 0, 2, 3)), p23));
+	_mm_storeu_si128(dst + 2, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 1, 0)));
+}
+
+static Packed16Block LoadPacked(const PackedVertex *in)
+{
+	const __m128i *src = reinterpret_cast<const __m128i *>(in);
+	__m128i r0 = _mm_loadu_si128(src + 0);
+	__m128i r1 = _mm_loadu_si128(src + 1);
+	__m128i r2 = _mm_loadu_si128(src + 2);
+
+	__m128i p01 = _mm_unpacklo_epi64(r0, _mm_unpacklo_epi32(_mm_srli_si128(r0, 12), r1));
+	__m128i p23 = _mm_unpackhi_epi64(r1, _mm_shuffle_epi32(r2, _MM_SHUFFLE(2, 1, 0, 0)));
+	__m128i uv = _mm_unpacklo_epi64(
+		_mm_unpacklo_epi32(_mm_shuffle_epi32(r0, _MM_SHUFFLE(0, 0, 0, 2)), _mm_shuffle_epi32(r1, _MM_SHUFFLE(0, 0, 0, 1))),
+		_mm_shuffle_epi32(r2, _MM_SHUFFLE(0, 0, 3, 0)));
+
+	// Back to four of each component
+	__m128i t0 = _mm_unpacklo_epi16(p01, p23);
+	__m128i t1 = _mm_unpackhi_epi16(p01, p23);
+	__m128i c = _mm_unpacklo_epi16(uv, _mm_srli_si128(uv, 8));
+
+	return{ _mm_unpacklo_epi16(t0, t1), _mm_unpackhi_epi16(t0, t1), _mm_unpacklo_epi16(c, _mm_srli_si128(c, 8)) };
+}
+
+// Two sets of four values in [0, 65535] to eight unsigned 16 bit values.
+// SSE2 only packs with signed saturation, so the range is shifted down and back
+static __m128i PackUnsigned16(__m128i a, __m128i b)
+{
+	const __m128i bias = _mm_set1_epi32(0x8000);
+	__m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(b, bias));
+	return _mm_xor_si128(packed, _mm_set1_epi16(static_cast<short>(0x8000)));
+}
+
+// Saturates to [0, 1] and rounds to nearest, as XMStoreUShortN4 does
+static __m128i ToUnorm16(__m128 v)
+{
+	v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	return _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(65535.0f)));
+}
+
+static __m128 FromUnorm16(__m128i v)
+{
+	return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1.0f / 65535.0f));
+}
+
+static __m128i TexCoordsToUnorm16(const FloatBlock &block)
+{
+	return PackUnsigned16(ToUnorm16(block.u), ToUnorm16(block.v));
+}
+
+static void TexCoordsFromUnorm16(__m128i uv, FloatBlock &block)
+{
+	block.u = FromUnorm16(_mm_unpacklo_epi16(uv, _mm_setzero_si128()));
+	block.v = FromUnorm16(_mm_unpackhi_epi16(uv, _mm_setzero_si128()));
+}
+
+// F16C instructions are VEX encoded, so the OS has to save AVX state as well
+static bool HasF16C()
+{
+	static const bool f16c = []()
+	{
+		int info[4];
+		__cpuid(info, 1);
+
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		bool halfConvert = (info[2] & (1 << 29)) != 0;
+
+		return osxsave && avx && halfConvert && (_xgetbv(0) & 0x6) == 0x6;
+	}();
+
+	return f16c;
+}
+#endif
+
+static void EncodeUnorm16(const VertexPositionTexture *in, uint32_t count, FXMVECTOR boundsMin, FXMVECTOR invExtent, PackedVertex *out)
+{
+#if defined(_XM_SSE_INTRINSICS_)
+	const __m128 minX = XMVectorSplatX(boundsMin), minY = XMVectorSplatY(boundsMin), minZ = XMVectorSplatZ(boundsMin);
+	const __m128 invX = XMVectorSplatX(invExtent), invY = XMVectorSplatY(invExtent), invZ = XMVectorSplatZ(invExtent);
+
+	ForEachBlock(in, count, out, [&](const VertexPositionTexture *block, PackedVertex *packed)
+	{
+		FloatBlock f = LoadFloats(block);
+
+		__m128i x = ToUnorm16(_mm_mul_ps(_mm_sub_ps(f.x, minX), invX));
+		__m128i y = ToUnorm16(_mm_mul_ps(_mm_sub_ps(f.y, minY), invY));
+		__m128i z = ToUnorm16(_mm_mul_ps(_mm_sub_ps(f.z, minZ), invZ));
+
+		StorePacked({ PackUnsigned16(x, y), PackUnsigned16(z, _mm_setzero_si128()), TexCoordsToUnorm16(f) }, packed);
+	});
+#else
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// Store saturates to [0, 1] and rounds to nearest
+		XMVECTOR p = XMVectorMultiply(XMVectorSubtract(XMLoadFloat3(&in[i].position), boundsMin), invExtent);
+		XMStoreUShortN4(reinterpret_cast<XMUSHORTN4 *>(out[i].position), p);
+		XMStoreUShortN2(reinterpret_cast<XMUSHORTN2 *>(out[i].texCoord), XMLoadFloat2(&in[i].texCoord));
+	}
+#endif
+}
+
+static void DecodeUnorm16(const PackedVertex *in, uint32_t count, FXMVECTOR boundsMin, FXMVECTOR extent, VertexPositionTexture *out)
+{
+#if defined(_XM_SSE_INTRINSICS_)
+	const __m128 minX = XMVectorSplatX(boundsMin), minY = XMVectorSplatY(boundsMin), minZ = XMVectorSplatZ(boundsMin);
+	const __m128 extX = XMVectorSplatX(extent), extY = XMVectorSplatY(extent), extZ = XMVectorSplatZ(extent);
+	const __m128i zero = _mm_setzero_si128();
+
+	ForEachBlock(in, count, out, [&](const PackedVertex *packed, VertexPositionTexture *block)
+	{
+		Packed16Block p = LoadPacked(packed);
+
+		FloatBlock f;
+		f.x = XMVectorMultiplyAdd(FromUnorm16(_mm_unpacklo_epi16(p.xy, zero)), extX, minX);
+		f.y = XMVectorMultiplyAdd(FromUnorm16(_mm_unpackhi_epi16(p.xy, zero)), extY, minY);
+		f.z = XMVectorMultiplyAdd(FromUnorm16(_mm_unpacklo_epi16(p.zw, zero)), extZ, minZ);
+		TexCoordsFromUnorm16(p.uv, f);
+
+		StoreFloats(f, block);
+	});
+#else
+	for (uint32_t i = 0; i < count; i++)
+	{
+		XMVECTOR p = XMLoadUShortN4(reinterpret_cast<const XMUSHORTN4 *>(in[i].position));
+		XMStoreFloat3(&out[i].position, XMVectorMultiplyAdd(p, extent, boundsMin));
+		XMStoreFloat2(&out[i].texCoord, XMLoadUShortN2(reinterpret_cast<const XMUSHORTN2 *>(in[i].texCoord)));
+	}
+#endif
+}
+
+static void EncodeHalf(const VertexPositionTexture *in, uint32_t count, FXMVECTOR center, PackedVertex *out)
+{
+#if defined(_XM_SSE_INTRINSICS_)
+	if (HasF16C())
+	{
+		const __m128 cX = XMVectorSplatX(center), cY = XMVectorSplatY(center), cZ = XMVectorSplatZ(center);
+
+		ForEachBlock(in, count, out, [&](const VertexPositionTexture *block, PackedVertex *packed)
+		{
+			FloatBlock f = LoadFloats(block);
+
+			__m128i x = _mm_cvtps_ph(_mm_sub_ps(f.x, cX), _MM_FROUND_TO_NEAREST_INT);
+			__m128i y = _mm_cvtps_ph(_mm_sub_ps(f.y, cY), _MM_FROUND_TO_NEAREST_INT);
+			__m128i z = _mm_cvtps_ph(_mm_sub_ps(f.z, cZ), _MM_FROUND_TO_NEAREST_INT);
+
+			StorePacked({ _mm_unpacklo_epi64(x, y), z, TexCoordsToUnorm16(f) }, packed);
+		});
+		return;
+	}
+#endif
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		XMVECTOR p = XMVectorSubtract(XMLoadFloat3(&in[i].position), center);
+		XMStoreHalf4(reinterpret_cast<XMHALF4 *>(out[i].position), p);
+		XMStoreUShortN2(reinterpret_cast<XMUSHORTN2 *>(out[i].texCoord), XMLoadFloat2(&in[i].texCoord));
+	}
+}
+
+static void DecodeHalf(const PackedVertex *in, uint32_t count, FXMVECTOR center, VertexPositionTexture *out)
+{
+#if defined(_XM_SSE_INTRINSICS_)
+	if (HasF16C())
+	{
+		const __m128 cX = XMVectorSplatX(center), cY = XMVectorSplatY(center), cZ = XMVectorSplatZ(center);
+
+		ForEachBlock(in, count, out, [&](const PackedVertex *packed, VertexPositionTexture *block)
+		{
+			Packed16Block p = LoadPacked(packed);
+
+			FloatBlock f;
+			f.x = _mm_add_ps(_mm_cvtph_ps(p.xy), cX);
+			f.y = _mm_add_ps(_mm_cvtph_ps(_mm_srli_si128(p.xy, 8)), cY);
+			f.z = _mm_add_ps(_mm_cvtph_ps(p.zw), cZ);
+			TexCoordsFromUnorm16(p.uv, f);
+
+			StoreFloats(f, block);
+		});
+		return;
+	}
+#endif
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		XMVECTOR p = XMLoadHalf4(reinterpret_cast<const XMHALF4 *>(in[i].position));
+		XMStoreFloat3(&out[i].position, XMVectorAdd(p, center));
+		XMStoreFloat2(&out[i].texCoord, XMLoadUShortN2(reinterpret_cast<const XMUSHORTN2 *>(in[i].texCoord)));
+	}
+}
+
+// Per axis 1 / extent, flat axes get 0 so every vertex lands on the minimum
+static XMVECTOR InverseExtent(const XMFLOAT3 &boundsMin, const XMFLOAT3 &boundsMax)
+{
+	auto inverse = [](float lo, float hi) { return (hi > lo) ? 1.0f / (hi - lo) : 0.0f; };
+
+	return XMVectorSet(inverse(boundsMin.x, boundsMax.x),
+					   inverse(boundsMin.y, boundsMax.y),
+					   inverse(boundsMin.z, boundsMax.z),
+					   0.0f);
+}
+
+uint32_t PackedMesh::VertexListSize() const
+{
+	return static_cast<uint32_t>(vertices.size()) * VertexStride();
+}
+
+uint32_t PackedMesh::VertexStride() const
+{
+	return (format == PositionFormat::Unorm16) ? VertexPositionTextureUnorm16::Size : VertexPositionTextureHalf::Size;
+}
+
+uint32_t PackedMesh::VertexId() const
+{
+	return (format == PositionFormat::Unorm16) ? VertexPositionTextureUnorm16::Id : VertexPositionTextureHalf::Id;
+}
+
+XMMATRIX PackedMesh::DecodeTransform() const
+{
+	XMVECTOR lo = XMLoadFloat3(&boundsMin);
+	XMVECTOR hi = XMLoadFloat3(&boundsMax);
+
+	if (format == PositionFormat::Unorm16)
+	{
+		XMVECTOR extent = XMVectorSubtract(hi, lo);
+		return XMMatrixMultiply(XMMatrixScalingFromVector(extent), XMMatrixTranslationFromVector(lo));
+	}
+
+	XMVECTOR center = XMVectorScale(XMVectorAdd(lo, hi), 0.5f);
+	return XMMatrixTranslationFromVector(center);
+}
+
+PackedMesh Learnings::Pack(const Mesh &mesh, PositionFormat format)
+{
+	PackedMesh packed;
+	packed.format = format;
+	packed.indices = mesh.indices;
+	packed.vertices.resize(mesh.vertices.size());
+
+	XMVECTOR lo = XMVectorZero(), hi = XMVectorZero();
+	if (!mesh.vertices.empty())
+	{
+		lo = hi = XMLoadFloat3(&mesh.vertices[0].position);
+		for (auto &v : mesh.vertices)
+		{
+			XMVECTOR p = XMLoadFloat3(&v.position);
+			lo = XMVectorMin(lo, p);
+			hi = XMVectorMax(hi, p);
+		}
+	}
+	XMStoreFloat3(&packed.boundsMin, lo);
+	XMStoreFloat3(&packed.boundsMax, hi);
+
+	uint32_t count = static_cast<uint32_t>(mesh.vertices.size());
+	if (format == PositionFormat::Unorm16)
+	{
+		EncodeUnorm16(mesh.vertices.data(), count, lo, InverseExtent(packed.boundsMin, packed.boundsMax), packed.vertices.data());
+	}
+	else
+	{
+		EncodeHalf(mesh.vertices.data(), count, XMVectorScale(XMVectorAdd(lo, hi), 0.5f), packed.vertices.data());
+	}
+
+	return packed;
+}
+
+Mesh Learnings::Unpack(const PackedMesh &mesh)
+{
+	Mesh unpacked;
+	unpacked.indices = mesh.indices;
+	unpacked.vertices.resize(mesh.vertices.size());
+
+	XMVECTOR lo = XMLoadFloat3(&mesh.boundsMin);
+	XMVECTOR hi = XMLoadFloat3(&mesh.boundsMax);
+
+	uint32_t count = static_cast<uint32_t>(mesh.vertices.size());
+	if (mesh.format == PositionFormat::Unorm16)
+	{
+		DecodeUnorm16(mesh.vertices.data(), count, lo, XMVectorSubtract(hi, lo), unpacked.vertices.data());
+	}
+	else
+	{
+		DecodeHalf(mesh.vertices.data(), count, XMVectorScale(XMVectorAdd(lo, hi), 0.5f), unpacked.vertices.data());
+	}
+
+	return unpacked;
+}
+
+QuantizationError Learnings::MeasureQuantization(const Mesh &mesh, PositionFormat format)
+{
+	QuantizationError error{ 0.0f, 0.0f, 0.0f, 0 };
+
+	auto packed = Pack(mesh, format);
+	auto decoded = Unpack(packed);
+
+	double sumSq = 0.0;
+	for (size_t i = 0; i < mesh.vertices.size(); i++)
+	{
+		XMVECTOR dp = XMVectorSubtract(XMLoadFloat3(&mesh.vertices[i].position), XMLoadFloat3(&decoded.vertices[i].position));
+		XMVECTOR dt = XMVectorAbs(XMVectorSubtract(XMLoadFloat2(&mesh.vertices[i].texCoord), XMLoadFloat2(&decoded.vertices[i].texCoord)));
+
+		float d = XMVectorGetX(XMVector3Length(dp));
+		error.maxPosition = std::max(error.maxPosition, d);
+		error.maxTexCoord = std::max(error.maxTexCoord, std::max(XMVectorGetX(dt), XMVectorGetY(dt)));
+		sumSq += d * d;
+	}
+
+	if (!mesh.vertices.empty())
+	{
+		error.rmsPosition = static_cast<float>(std::sqrt(sumSq / mesh.vertices.size()));
+	}
+	error.bytesSaved = mesh.VertexListSize() - packed.VertexListSize();
+
+	return error;
+}
+
+PositionFormat Learnings::PickPositionFormat(const Mesh &mesh)
+{
+	auto unorm16 = MeasureQuantization(mesh, PositionFormat::Unorm16);
+	auto half = MeasureQuantization(mesh, PositionFormat::Half);
+
+	return (half.maxPosition < unorm16.maxPosition) ? PositionFormat::Half : PositionFormat::Unorm16;
+}
+
+std::string Learnings::QuantizationReport(const Mesh &mesh)
+{
+	std::ostringstream report;
+
+	report << mesh.vertices.size() << " vertices, " << mesh.VertexListSize() << " bytes\n";
+
+	const std::pair<PositionFormat, const char *> formats[] = {
+		{ PositionFormat::Unorm16, "unorm16" },
+		{ PositionFormat::Half, "half" },
+	};
+
+	float best = 0.0f;
+	const char *pick = nullptr;
+	for (auto &format : formats)
+	{
+		auto error = MeasureQuantization(mesh, format.first);
+		if (pick == nullptr || error.maxPosition < best)
+		{
+			best = error.maxPosition;
+			pick = format.second;
+		}
+
+		report << "  " << std::left << std::setw(8) << format.second << std::right
+			<< std::scientific << std::setprecision(2)
+			<< " position max " << error.maxPosition
+			<< " rms " << error.rmsPosition
+			<< "  texCoord max " << error.maxTexCoord
+			<< "  saved " << error.bytesSaved << " bytes\n";
+	}
+	report << "  pick " << pick << "\n";
+
+	return report.str();
+}
+#pragma endregion
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <vector>
+#include <string>
 #include <cstdint>
 #include <DirectXMath.h>
 #include <d3d11.h>
@@ -30,7 +31,86 @@ namespace Learnings
 		uint32_t VertexListSize() const;
 		uint32_t IndexListSize() const;
 
+		// Index width on the GPU, 16 bit whenever the vertex count allows it.
+		// 0xFFFF stays free as the strip cut value
+		DXGI_FORMAT IndexFormat() const;
+		// Indices narrowed to IndexFormat(), IndexListSize() bytes long
+		std::vector<uint8_t> IndexData() const;
+
 		static uint32_t VertexStride();
 	};
 
+	// 12 byte storage shared by the packed vertex formats.
+	// D3D11 has no 3 component 16 bit format, so position carries an unused w
+	struct PackedVertex
+	{
+		uint16_t position[4];
+		uint16_t texCoord[2];	// unorm16 over [0, 1]
+	};
+
+	// Position as unorm16 across the mesh bounds, best precision for a bounded mesh
+	struct VertexPositionTextureUnorm16 : PackedVertex
+	{
+		static const uint8_t C_VertexElementCount = 2;
+		static const std::array<D3D11_INPUT_ELEMENT_DESC, C_VertexElementCount> ElementsDesc;
+		static const uint32_t Size;
+		static const uint32_t Id;
+	};
+
+	// Position as half float relative to the bounds center, keeps precision near the center
+	struct VertexPositionTextureHalf : PackedVertex
+	{
+		static const uint8_t C_VertexElementCount = 2;
+		static const std::array<D3D11_INPUT_ELEMENT_DESC, C_VertexElementCount> ElementsDesc;
+		static const uint32_t Size;
+		static const uint32_t Id;
+	};
+
+	enum class PositionFormat
+	{
+		Unorm16,
+		Half
+	};
+
+	// Mesh with quantised vertices, 12 bytes per vertex instead of 20
+	struct PackedMesh
+	{
+		typedef std::vector<PackedVertex> VertexList;
+
+		VertexList vertices;
+		Mesh::IndexList indices;
+
+		PositionFormat format;
+		DirectX::XMFLOAT3 boundsMin;
+		DirectX::XMFLOAT3 boundsMax;
+
+		uint32_t VertexListSize() const;
+		uint32_t VertexStride() const;
+		uint32_t VertexId() const;
+
+		// Turns decoded positions back into mesh space,
+		// fold it into the world transform so the shader needs no changes
+		DirectX::XMMATRIX DecodeTransform() const;
+	};
+
+	// Encode/decode whole meshes, indices are copied as they are
+	PackedMesh Pack(const Mesh &mesh, PositionFormat format);
+	Mesh Unpack(const PackedMesh &mesh);
+
+	// Round trip error, in mesh units for position and uv units for texCoord
+	struct QuantizationError
+	{
+		float maxPosition;
+		float rmsPosition;
+		float maxTexCoord;	// uv outside [0, 1] is clamped and shows up here
+		uint32_t bytesSaved;
+	};
+
+	QuantizationError MeasureQuantization(const Mesh &mesh, PositionFormat format);
+
+	// The format with the smaller largest position error for this mesh
+	PositionFormat PickPositionFormat(const Mesh &mesh);
+
+	// Compare both formats for a mesh and name the pick, returns a text report
+	std::string QuantizationReport(const Mesh &mesh);
 }
\ No newline at end of file